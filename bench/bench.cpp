@@ -0,0 +1,142 @@
+//
+// sql_LV++ benchmark, drives the LabVIEW exports without LabVIEW (memory manager in lvstub.cpp)
+// Desc:   Creates a table of the requested type mix, then times UpdatePrepared (insert), Query and
+//         QueryColumnar (select) over a number of iterations, reporting rows/sec, bytes/sec,
+//         p50/p99 latency and LV handle allocations per row.
+//
+//  usage: bench [-api mysql|odbc] [-host h] [-user u] [-pw p] [-db d] [-rows n] [-types idsb]
+//               [-str n] [-blob n] [-iter n] [-table t]
+//         types, one letter per column: i I32, u U32, w I16, b U8, f SGL, d DBL, s String, x BLOB
+//         -api odbc takes a connection string as -host, e.g. "DRIVER=SQLite3;Database=/tmp/bench.db"
+//
+#include "../sql_LVpp.cpp"  //  single translation unit, the exports and their LV types
+#include <algorithm>
+#include <functional>
+
+static LStrHandle Str(string s) { return LVStr(s); }
+
+struct tResult {
+    string name;
+    vector<double> ms;      //  latency per iteration
+    long rows = 0, bytes = 0;
+    LvStubStats mem = {0, 0, 0, 0};
+};
+
+static void Report(tResult& r)
+{
+    sort(r.ms.begin(), r.ms.end());
+    double total = 0; for (double t : r.ms) total += t;
+    double p50 = r.ms.empty() ? 0 : r.ms[r.ms.size() / 2], p99 = r.ms.empty() ? 0 : r.ms[(r.ms.size() * 99) / 100 < r.ms.size() ? (r.ms.size() * 99) / 100 : r.ms.size() - 1];
+    double rows = r.rows ? r.rows : 1;
+    printf("%-14s %12.0f rows/s %10.2f MB/s   p50 %9.3f ms   p99 %9.3f ms   %6.2f allocs/row  %6.2f resizes/row\n",
+        r.name.c_str(), r.rows / (total / 1000), r.bytes / (total / 1000) / 1e6, p50, p99,
+        r.mem.allocs / rows, r.mem.resizes / rows);
+}
+
+static void Check(LvDbRef ref, int rc, string what)  //  print library error and quit on failure
+{
+    if (rc >= 0) return;
+    auto Empty = [] { return (LStrHandle) DSNewHClr(sizeof(int32)); };  //  GetError() copies into the handles, LVStr("") is NULL
+    tLvDbErr e = {0, Empty(), Empty(), Empty()};
+    GetError(ref, &e);
+    fprintf(stderr, "%s failed (%ld): %s\n", what.c_str(), e.errnum, LStrString(e.errstr).c_str());
+    DSDisposeHandle(e.errstr); DSDisposeHandle(e.errdata); DSDisposeHandle(e.SQLstate);
+    exit(1);
+}
+
+static void FreeCells(LStrHandle* elt, long n) { for (long k = 0; k < n; k++) if (elt[k]) DSDisposeHandle(elt[k]); }
+
+int main(int argc, char* argv[])
+{
+    string api = "mysql", host = "localhost", user = "root", pw = "", db = "test", types = "idsx", table = "sql_lv_bench";
+    int rows = 10000, StrLen = 32, BlobLen = 1024, iter = 10;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        string a = argv[i], v = argv[i + 1];
+        if (a == "-api") api = v;           else if (a == "-host") host = v;
+        else if (a == "-user") user = v;    else if (a == "-pw") pw = v;
+        else if (a == "-db") db = v;        else if (a == "-table") table = v;
+        else if (a == "-types") types = v;  else if (a == "-rows") rows = atoi(v.c_str());
+        else if (a == "-str") StrLen = atoi(v.c_str());
+        else if (a == "-blob") BlobLen = atoi(v.c_str());
+        else if (a == "-iter") iter = atoi(v.c_str());
+        else { fprintf(stderr, "unknown option %s\n", a.c_str()); return 2; }
+    }
+
+    //  column TDs, SQL types and one flattened (native byte order) value per column
+    int cols = types.length();
+    vector<uint16_t> td(cols); vector<string> val(cols); string ddl;
+    for (int i = 0; i < cols; i++)
+    {
+        string sql; int32 i32 = 123456 + i; uInt32 u32 = 4000000000u; int16 i16 = -1234; uChar u8 = 200;
+        float f = 3.25f; double d = 2.718281828459045;
+        switch (types[i])
+        {
+        case 'i': td[i] = LvDbLib::I32; sql = "INT"; val[i].assign((char*) &i32, sizeof(i32)); break;
+        case 'u': td[i] = LvDbLib::U32; sql = "INT UNSIGNED"; val[i].assign((char*) &u32, sizeof(u32)); break;
+        case 'w': td[i] = LvDbLib::I16; sql = "SMALLINT"; val[i].assign((char*) &i16, sizeof(i16)); break;
+        case 'b': td[i] = LvDbLib::U8; sql = "TINYINT UNSIGNED"; val[i].assign((char*) &u8, sizeof(u8)); break;
+        case 'f': td[i] = LvDbLib::SGL; sql = "FLOAT"; val[i].assign((char*) &f, sizeof(f)); break;
+        case 'd': td[i] = LvDbLib::DBL; sql = "DOUBLE"; val[i].assign((char*) &d, sizeof(d)); break;
+        case 's': td[i] = LvDbLib::String; sql = "VARCHAR(" + to_string(StrLen) + ")"; val[i] = string(StrLen, 'a' + i % 26); break;
+        case 'x': td[i] = LvDbLib::Array; sql = "LONGBLOB"; val[i] = string(BlobLen, (char) i); break;
+        default: fprintf(stderr, "unknown type '%c'\n", types[i]); return 2;
+        }
+        ddl += (i ? ", c" : "c") + to_string(i) + " " + sql;
+    }
+    long RowBytes = 0; for (auto& v : val) RowBytes += v.length();
+
+    LvDbRef ref = OpenDB(Str(host), Str(user), Str(pw), Str(db), api == "odbc" ? LvDbLib::ODBC : LvDbLib::MySQL);
+    if (!ref) { fprintf(stderr, "OpenDB failed\n"); return 1; }
+    { shared_ptr<LvDbLib> o = myObjs.Get(ref); if (o->errnum) Check(ref, -1, "OpenDB"); }
+    Check(ref, SetBufLen(ref, max(StrLen, BlobLen) + 1, 0), "SetBufLen");
+    Execute(ref, Str("DROP TABLE IF EXISTS " + table));
+    Check(ref, Execute(ref, Str("CREATE TABLE " + table + " (" + ddl + ")")), "CREATE TABLE");
+
+    //  DataSet of "rows" copies of the row, the way LV passes a 2D string array
+    DataSetHdl data = (DataSetHdl) DSNewHClr(sizeof(long) * 2 + (size_t) rows * cols * sizeof(LStrHandle));
+    (**data).dimSizes[0] = rows; (**data).dimSizes[1] = cols;
+    for (int j = 0; j < rows; j++) for (int i = 0; i < cols; i++) (**data).elt[j * cols + i] = Str(val[i]);
+    TypesHdl th = (TypesHdl) DSNewHClr(sizeof(long) + cols);
+    (**th).dimSize = cols; for (int i = 0; i < cols; i++) (**th).TypeDescriptor[i] = td[i];
+
+    string sel = "SELECT "; for (int i = 0; i < cols; i++) sel += (i ? ", c" : "c") + to_string(i);
+    string marks = "?"; for (int i = 1; i < cols; i++) marks += ", ?";
+    LStrHandle ins = Str("INSERT INTO " + table + " VALUES (" + marks + ")");
+    LStrHandle del = Str("DELETE FROM " + table), query = Str(sel + " FROM " + table);
+
+    tResult insert, select, columnar; insert.name = "UpdatePrepared"; select.name = "Query"; columnar.name = "QueryColumnar";
+    auto Time = [&](tResult& r, function<long()> f) {
+        LvStubStats m0 = LvStub; auto t0 = chrono::steady_clock::now();
+        long n = f();
+        r.ms.push_back(chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count());
+        r.rows += n; r.bytes += n * RowBytes;
+        r.mem.allocs += LvStub.allocs - m0.allocs; r.mem.resizes += LvStub.resizes - m0.resizes;
+    };
+
+    printf("%s: %d rows x %d cols (%s), %ld bytes/row, %d iterations\n", api.c_str(), rows, cols, types.c_str(), RowBytes, iter);
+    for (int k = 0; k < iter; k++)
+    {
+        Check(ref, Execute(ref, del), "DELETE");
+        Time(insert, [&] { int n = UpdatePrepared(ref, ins, data, &td[0]); Check(ref, n, "UpdatePrepared"); return n; });
+
+        ResultSetHdl res = (ResultSetHdl) DSNewHClr(sizeof(long) * 2);
+        Time(select, [&] { int n = Query(ref, query, th, res); Check(ref, n, "Query"); return n; });
+        FreeCells((**res).elt, (**res).dimSizes[0] * (**res).dimSizes[1]); DSDisposeHandle(res);
+
+        vector<UHandle> columns(cols, (UHandle) NULL); LStrArrayHdl nulls = (LStrArrayHdl) DSNewHClr(LvArrayHdr(sizeof(LStrHandle)));
+        Time(columnar, [&] { int n = QueryColumnar(ref, query, th, &columns[0], nulls); Check(ref, n, "QueryColumnar"); return n; });
+        for (int i = 0; i < cols; i++)
+        {
+            if (!columns[i]) continue;
+            if (td[i] == LvDbLib::String || td[i] == LvDbLib::Array) FreeCells(((LStrArray*) *columns[i])->elt, ((LStrArray*) *columns[i])->dimSize);
+            DSDisposeHandle(columns[i]);
+        }
+        FreeCells((**nulls).elt, (**nulls).dimSize); DSDisposeHandle(nulls);
+    }
+    Report(insert); Report(select); Report(columnar);
+
+    Execute(ref, Str("DROP TABLE " + table));
+    CloseDB(ref);
+    return 0;
+}
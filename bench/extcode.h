@@ -0,0 +1,52 @@
+//
+// Stand-in for LabVIEW cintools extcode.h, so sql_LV++ can be built and benchmarked without LabVIEW.
+// Only what sql_LVpp.cpp uses: LV scalar types, LStr, and the DS memory manager (lvstub.cpp),
+// which counts allocations so bench can report them per row.
+//
+#ifndef _extcode_H
+#define _extcode_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef int8_t int8;
+typedef uint8_t uInt8;
+typedef uint8_t uChar;
+typedef int16_t int16;
+typedef uint16_t uInt16;
+typedef int32_t int32;
+typedef uint32_t uInt32;
+typedef int64_t int64;
+typedef uint64_t uInt64;
+typedef int32 MgErr;
+
+enum { mgNoErr = 0, mFullErr = 2, mZoneErr = 3 };
+
+typedef uChar *UPtr, **UHandle;
+typedef struct {
+    int32 cnt;      //  number of bytes that follow
+    uChar str[1];   //  cnt bytes
+} LStr, *LStrPtr, **LStrHandle;
+
+typedef struct {    //  memory manager counters, see lvstub.cpp
+    long allocs;    //  handles created
+    long resizes;   //  DSSetHandleSize() calls
+    long frees;     //  handles disposed
+    long bytes;     //  bytes requested by creates and resizes
+} LvStubStats;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+UHandle DSNewHandle(size_t size);
+UHandle DSNewHClr(size_t size);
+MgErr DSSetHandleSize(void* h, size_t size);
+int32 DSGetHandleSize(void* h);
+MgErr DSDisposeHandle(void* h);
+MgErr DSCopyHandle(void* ph, const void* hsrc);
+extern LvStubStats LvStub;
+#ifdef __cplusplus
+}
+#endif
+
+#endif
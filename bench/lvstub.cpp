@@ -0,0 +1,57 @@
+//
+// malloc-backed LabVIEW memory manager for bench: a handle points at a master pointer, as in LV,
+// so the data may move on resize while the handle stays put. Every call is counted in LvStub.
+//
+#include <stdlib.h>
+#include <string.h>
+#include "extcode.h"
+
+LvStubStats LvStub;
+
+struct tMaster {    //  handle is &p, size lives next to it
+    UPtr p;
+    size_t size;
+};
+
+static UHandle NewHandle(size_t size, bool clear)
+{
+    tMaster* m = (tMaster*) malloc(sizeof(tMaster)); if (!m) return NULL;
+    if (!(m->p = (UPtr) (clear ? calloc(1, size ? size : 1) : malloc(size ? size : 1)))) { free(m); return NULL; }
+    m->size = size;
+    LvStub.allocs++; LvStub.bytes += size;
+    return &m->p;
+}
+
+UHandle DSNewHandle(size_t size) { return NewHandle(size, false); }
+UHandle DSNewHClr(size_t size) { return NewHandle(size, true); }
+
+MgErr DSSetHandleSize(void* h, size_t size)
+{
+    if (!h) return mZoneErr;
+    tMaster* m = (tMaster*) h;
+    UPtr p = (UPtr) realloc(m->p, size ? size : 1); if (!p) return mFullErr;
+    m->p = p; m->size = size;
+    LvStub.resizes++; LvStub.bytes += size;
+    return mgNoErr;
+}
+
+int32 DSGetHandleSize(void* h) { return h ? (int32) ((tMaster*) h)->size : 0; }
+
+MgErr DSDisposeHandle(void* h)
+{
+    if (!h) return mZoneErr;
+    tMaster* m = (tMaster*) h;
+    free(m->p); free(m);
+    LvStub.frees++;
+    return mgNoErr;
+}
+
+MgErr DSCopyHandle(void* ph, const void* hsrc)  //  *ph = copy of hsrc, reusing *ph if it exists
+{
+    const tMaster* s = (const tMaster*) hsrc; UHandle* d = (UHandle*) ph;
+    if (!s || !d) return mZoneErr;
+    if (!*d) { if (!(*d = DSNewHandle(s->size))) return mFullErr; }
+    else if (DSSetHandleSize(*d, s->size) != mgNoErr) return mFullErr;
+    memcpy(**d, s->p, s->size);
+    return mgNoErr;
+}
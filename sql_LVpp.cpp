@@ -25,6 +25,8 @@
 
 
 #ifdef WIN
+    #include <winsock2.h>   //  WSAPoll(), asynchronous query event loop
+    #define poll WSAPoll
     #include <windows.h>
     #include "extcode.h" //  LabVIEW external code
     #include <string>
@@ -37,20 +39,34 @@
     #endif
 #else
     #include <arpa/inet.h>
-    #include "/usr/local/lv71/cintools/extcode.h" //  LabVIEW external code
+    #include <poll.h>       //  asynchronous query event loop
+    #include "extcode.h"     //  LabVIEW external code, cintools directory from Makefile INCLUDES
     #include <string.h>
     typedef int errno_t;
 #endif
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <stddef.h> //  offsetof()
 #include <iostream> // std::cout
 #include <list>     //  container of generated objects for error checking (avoid SEGFAULT)
 #include <variant>  //  container for field data
 #define VAR_TYPES char, short, long, unsigned long, float, char*, void*, double, string
 #include <vector>   //  container for results
 #include <array>   //  container for results
+#include <cmath>    //  EXT to/from IEEE quad
+#include <limits>
+#include <algorithm>
 #include <sstream>
+#include <unordered_map>    //  prepared statement cache index
+#include <unordered_set>
+#include <mutex>            //  per-connection lock, connection pool checkout/checkin
+#include <shared_mutex>     //  object registry
+#include <memory>
+#include <atomic>
+#include <condition_variable>
+#include <chrono>
+#include <thread>           //  asynchronous query event loop
 
 using namespace std;
 
@@ -77,9 +93,54 @@ typedef struct {
     unsigned char TypeDescriptor[1]; //  Array of LabVIEW types corresponding to expected result set
 } Types;
 typedef Types** TypesHdl;
+#if defined(WIN) && !defined(_WIN64)
+#pragma pack(push, 1)   //  32-bit Windows LV packs arrays, elements start right after dimSize
+#endif
+template <typename T> struct LvArray {  //  1D LV array, elsewhere the compiler pads dimSize to the element alignment like LV does
+    int32 dimSize;
+    T elt[1];
+};
+#if defined(WIN) && !defined(_WIN64)
+#pragma pack(pop)
+#endif
+typedef LvArray<LStrHandle> LStrArray;  //  1D array of strings, e.g. per-column NULL bitmaps
+typedef LStrArray** LStrArrayHdl;
+typedef LvArray<uInt16> U16Array;   //  1D array of U16, e.g. per-row status
+typedef U16Array** U16ArrayHdl;
+typedef LvArray<int32> I32Array;   //  1D array of I32, e.g. ExecuteBatch() rows affected
+typedef I32Array** I32ArrayHdl;
+typedef LvArray<uInt64> U64Array;   //  1D array of U64, e.g. GetStats() counters
+typedef U64Array** U64ArrayHdl;
+
+static thread_local uint64_t LvHandles, LvBytes;  //  LV handles and bytes made by this thread, see LvDbLib::tStats
+
+//  LabVIEW array utilities
+size_t LvArrayHdr(int size)    //  offset of first element in 1D array of "size"-byte elements
+{
+#if defined(WIN) && !defined(_WIN64)
+    return sizeof(int32);   //  packed, see LvArray
+#endif
+    switch (size)
+    {
+    case 1: return offsetof(LvArray<char>, elt);
+    case 2: return offsetof(LvArray<short>, elt);
+    case 4: return offsetof(LvArray<int32>, elt);
+    default: return offsetof(LvArray<double>, elt);
+    }
+}
+int LvArrayResize(UHandle* h, int size, int n, int align = 0)  //  (re)size 1D array handle of "size"-byte elements to n elements
+{   //  "align" of cluster elements, defaults to element size
+    size_t len = LvArrayHdr(align ? align : size) + (size_t) n * size;
+    if (*h == NULL) {if ((*h = DSNewHClr(len)) == NULL) return -1; LvHandles++;}
+    else if (DSSetHandleSize(*h, len) != mgNoErr) return -1;
+    ((LvArray<char>*) **h)->dimSize = n;
+    return 0;
+}
 
 //  LabVIEW string utilities
-#define LStrString(A) string((char*) (*A)->str, (*A)->cnt)
+#define LStrLen(A) ((A) ? (*A)->cnt : 0)    //  LV passes empty strings as NULL handles
+#define LStrBuf(A) ((A) ? (char*) (*A)->str : (char*) "")
+#define LStrString(A) string(LStrBuf(A), LStrLen(A))
 void LV_str_cp(LStrHandle LV_string, string c_str)
 {
     DSSetHandleSize(LV_string, sizeof(int) + c_str.length() * sizeof(char));
@@ -121,6 +182,7 @@ LStrHandle LVStr(string str)    //  convert string to new LV string handle
 {
     if (str.length() == 0) return NULL;
     LStrHandle l; if ((l = (LStrHandle) DSNewHClr(sizeof(int32) + str.length())) == NULL) return NULL;
+    LvHandles++; LvBytes += str.length();
     memmove((char*)(*l)->str, str.c_str(), ((*l)->cnt = str.length()));
     return l;
 }
@@ -128,6 +190,7 @@ LStrHandle LVStr(string str, int size)
 {
     if (size == 0) return NULL;
     LStrHandle l; if ((l = (LStrHandle) DSNewHClr(sizeof(int32) + size)) == NULL) return NULL;
+    LvHandles++; LvBytes += size;
     memmove((char*)(*l)->str, str.c_str(), ((*l)->cnt = size));
     return l;
 }
@@ -135,6 +198,7 @@ LStrHandle LVStr(char* str, int size)
 {
     if (size == 0) return NULL;
     LStrHandle l; if ((l = (LStrHandle) DSNewHClr(sizeof(int32) + size)) == NULL) return NULL;
+    LvHandles++; LvBytes += size;
     memmove((char*)(*l)->str, str, ((*l)->cnt = size));
     return l;
 }
@@ -172,8 +236,12 @@ public:
     string* errstr = NULL;    // error description
     string* errdata = NULL;   // data which precipitated error
     uint16_t type;    // RDMS type, see enum db_type.h
-    int StrBufLen = 256;    // initialize to 256
-    int StrBlobLen = 4096;  // Used when StrBufLen==0 as buffer length for BLOBs
+    int StrBufLen = 256;    // most bytes bound per string column, actual size from result metadata; longer values are fetched separately
+    int StrBlobLen = 4096;  // chunk size for string/BLOB columns read with SQLGetData() (ODBC)
+    int ParamSetSize = 1024;    // rows sent per execute by UpdatePrepared() parameter arrays (ODBC, MariaDB bulk), 0 for whole DataSet
+    int RowArraySize = 512;     // rows per SQLFetch() in GetResults() (ODBC block cursor), 1 for one row at a time
+    int CommitRows = 0, CommitMs = 0;   // UpdatePrepared() group commit every N rows and/or T ms, 0 for autocommit per statement
+    bool InTrans = false;   // explicit transaction open, see Begin()
 
     union API
     {
@@ -203,10 +271,181 @@ public:
 #endif
     } api;
 
+    struct tCursor {    //  streaming query state, see QueryOpen(), FetchChunk(), QueryClose()
+        bool open = false;
+        int cols = 0;
+        vector<unsigned char> td;   //  LV types of the result columns
+        vector<double> res;         //  bound numeric buffers, 8 bytes holds any numeric TD
+        vector<string> str;         //  bound string/BLOB buffers
+#ifdef MYAPI
+        MYSQL_STMT* stmt;
+        vector<MYSQL_BIND> bind;
+        vector<unsigned long> length;
+        vector<my_bool> is_null, error;
+#endif
+#ifdef ODBCAPI
+        SQLHSTMT hStmt;
+        vector<SQLLEN> DataLen;
+        vector<SQLSMALLINT> CType;
+        int FirstUnbound;   //  this column and all after it are read with SQLGetData()
+#endif
+    } cursor;
+
+    struct tBlob {      //  streamed BLOB state, see BlobWriteBegin(), BlobReadOpen(), BlobClose()
+        int mode = 0;       //  0 none, 1 writing parameters, 2 reading a row
+        int n = 0;          //  parameters (write) or columns (read)
+        int col = 0;        //  ODBC parameter or column being streamed, the driver only goes forward
+        int64_t pos = 0;    //  bytes of "col" read so far (ODBC)
+        bool sent = false;  //  "col" has been sent data (ODBC)
+#ifdef MYAPI
+        MYSQL_STMT* stmt;
+        vector<MYSQL_BIND> bind;
+        vector<unsigned long> length;
+        vector<my_bool> is_null;
+#endif
+#ifdef ODBCAPI
+        SQLHSTMT hStmt;
+        vector<SQLLEN> ind;  //  SQL_DATA_AT_EXEC for every parameter
+#endif
+    } blob;
+
+    struct tStmt {      //  cached prepared statement, MYSQL_STMT* or SQLHSTMT
+        string query;
+        void* h;
+    };
+    list<tStmt> StmtCache;  //  most recently used first
+    unordered_map<string, list<tStmt>::iterator> StmtIndex;
+    unordered_set<void*> StmtHandles;
+    int StmtCacheSize = 16; //  prepared statements kept per connection, 0 disables cache
+    long StmtHits = 0, StmtMisses = 0;
+
+    struct tCachedResult {  //  Query() result kept for ResultTtlMs, cells packed into one string
+        string key;             //  SQL text and column TDs
+        string data;            //  cell bytes back to back
+        vector<uint32_t> end;   //  end of each cell in data, row-major; NULL cells are empty, as LV gets them
+        int rows, cols;
+        size_t bytes;           //  counted against ResultCacheMax
+        chrono::steady_clock::time_point expires;
+        vector<string> tables; //  read by the query, see SqlTables()
+    };
+    list<tCachedResult> ResultCache;    //  most recently used first
+    unordered_map<string, list<tCachedResult>::iterator> ResultIndex;
+    int ResultTtlMs = 0;                //  lifetime of cached results, 0 disables cache
+    size_t ResultCacheBytes = 0, ResultCacheMax = 16 << 20;
+    long ResultHits = 0, ResultMisses = 0;
+    atomic<uintptr_t> pool{0};  //  owning LvDbPool handle, pooled connections are returned with Release() not CloseDB()
+    bool CheckedOut = false;    //  pooled connection handed out by Acquire() and not yet released, guarded by LvDbPool::lock
+    mutex lock;             //  held by the export using this connection, see GET_OBJ()
+    atomic<bool> async{false};  //  connection in use by the event loop until Wait(), see QueryAsync()
+
+    struct tStats {     //  performance counters, relaxed atomics so GetStats() can read them without the connection lock
+        enum {Query, Execute, Update, Ops};     //  Query() and the other result set exports, Execute(), UpdatePrepared()
+        enum {Calls, Rows, Errors, BytesIn, BytesOut, Handles, Counters};
+        enum {Prepare, Exec, Fetch, Convert, Phases};
+        static const int Buckets = 24;          //  bucket b counts phases of [2^b, 2^(b+1)) us, bucket 0 includes 0 us
+        atomic<uint64_t> count[Ops][Counters], us[Ops][Phases], hist[Ops][Phases][Buckets];
+
+        tStats() { Reset(); }
+        void Reset() {
+            for (auto& c : count) for (auto& n : c) n.store(0, memory_order_relaxed);
+            for (auto& c : us) for (auto& n : c) n.store(0, memory_order_relaxed);
+            for (auto& c : hist) for (auto& p : c) for (auto& n : p) n.store(0, memory_order_relaxed);
+        }
+        void Count(int op, int c, uint64_t n = 1) { count[op][c].fetch_add(n, memory_order_relaxed); }
+        void Time(int op, int phase, uint64_t t) {  //  add phase of "t" us to total and histogram
+            us[op][phase].fetch_add(t, memory_order_relaxed);
+            int b = 0; while ((t >>= 1) && b < Buckets - 1) b++;
+            hist[op][phase][b].fetch_add(1, memory_order_relaxed);
+        }
+        void Time(int op, int phase, chrono::steady_clock::time_point& t0) {  //  phase started at t0, ends now; t0 starts the next
+            auto t = chrono::steady_clock::now();
+            Time(op, phase, chrono::duration_cast<chrono::microseconds>(t - t0).count()); t0 = t;
+        }
+        void Split(int op, chrono::steady_clock::time_point& t0, chrono::steady_clock::duration fetch) {  //  end of fetch loop,
+            auto t = chrono::steady_clock::now();   //  "fetch" of it in driver fetch calls (ODBC), the rest converting to LV
+            if (fetch.count()) Time(op, Fetch, chrono::duration_cast<chrono::microseconds>(fetch).count());
+            Time(op, Convert, chrono::duration_cast<chrono::microseconds>(t - t0 - fetch).count()); t0 = t;
+        }
+    } stats;
+    struct tStatCall {  //  one export call: rows or error, LV handles and bytes made meanwhile; counted on scope exit
+        tStats& s; int op; int rows = -1;
+        uint64_t h0 = LvHandles, b0 = LvBytes;
+        tStatCall(tStats& st, int o) : s(st), op(o) {}
+        int operator()(int r) { return rows = r; }  //  success, "return call(rows);"
+        ~tStatCall() {
+            s.Count(op, tStats::Calls);
+            if (rows < 0) s.Count(op, tStats::Errors); else s.Count(op, tStats::Rows, rows);
+            s.Count(op, tStats::Handles, LvHandles - h0); s.Count(op, tStats::BytesIn, LvBytes - b0);
+        }
+    };
+
 #include "db_type.h"
 #include "LvTypeDescriptors.h"
+    enum { Timestamp = Waveform };  //  LV timestamp column (Waveform TD, timestamp sub-type), flattened as LvTime
+
+    static vector<pair<string, string>> SplitOptions(const string& options) {  //  "key=value;key;..." in order, a bare key is "1"
+        vector<pair<string, string>> opts; stringstream ss(options); string kv;
+        auto trim = [](string x) { size_t a = x.find_first_not_of(" \t"), b = x.find_last_not_of(" \t");
+                                   return a == string::npos ? string() : x.substr(a, b - a + 1); };
+        while (getline(ss, kv, ';'))
+        {
+            size_t eq = kv.find('='); string k = trim(kv.substr(0, eq));
+            if (k.length()) opts.push_back({k, eq == string::npos ? "1" : trim(kv.substr(eq + 1))});
+        }
+        return opts;
+    }
+
+#ifdef MYAPI
+    int MyOptions(const string& options, unsigned int& port, string& socket) {  //  OpenDBEx() options, set before connecting
+        for (auto& o : SplitOptions(options))
+        {
+            string k = o.first; transform(k.begin(), k.end(), k.begin(), ::tolower);
+            const string& v = o.second; unsigned int n = strtoul(v.c_str(), NULL, 10); unsigned long l = n; int rc = 0;
+            if (k == "port") port = n;
+            else if (k == "socket") socket = v;
+            else if (k == "compress") {if (n) rc = mysql_options(api.my.con, MYSQL_OPT_COMPRESS, NULL);}  //  zlib, CPU for bandwidth
+            else if (k == "protocol")
+            {
+                string w = v; transform(w.begin(), w.end(), w.begin(), ::tolower);
+                unsigned int p = (w == "tcp" ? MYSQL_PROTOCOL_TCP : w == "socket" ? MYSQL_PROTOCOL_SOCKET : w == "pipe" ? MYSQL_PROTOCOL_PIPE :
+                                  w == "memory" ? MYSQL_PROTOCOL_MEMORY : MYSQL_PROTOCOL_DEFAULT);
+                if (p == MYSQL_PROTOCOL_DEFAULT && w != "default") rc = 1;
+                else rc = mysql_options(api.my.con, MYSQL_OPT_PROTOCOL, &p);
+            }
+            else if (k == "connect_timeout") rc = mysql_options(api.my.con, MYSQL_OPT_CONNECT_TIMEOUT, &n);   //  seconds
+            else if (k == "read_timeout") rc = mysql_options(api.my.con, MYSQL_OPT_READ_TIMEOUT, &n);
+            else if (k == "write_timeout") rc = mysql_options(api.my.con, MYSQL_OPT_WRITE_TIMEOUT, &n);
+            else if (k == "net_buffer_length") rc = mysql_options(api.my.con, MYSQL_OPT_NET_BUFFER_LENGTH, &l);  //  bytes
+            else {errnum = -1; errstr = new string("Unknown connection option: " + o.first); return -1;}
+            if (rc) {errnum = -1; errstr = new string("Invalid connection option: " + o.first + "=" + v); return -1;}
+        }
+        return 0;
+    }
+#endif
+
+#ifdef ODBCAPI
+    SQLULEN QueryTimeout = 0;   //  s, read_timeout option, SQL_ATTR_QUERY_TIMEOUT of every statement; 0 none
+
+    void StmtTimeout(SQLHSTMT h) { if (QueryTimeout) SQLSetStmtAttr(h, SQL_ATTR_QUERY_TIMEOUT, (SQLPOINTER) QueryTimeout, 0); }
+
+    int OdbcOptions(const string& options, string& cs) {  //  OpenDBEx() options: connect_timeout and net_buffer_length as connection
+        //  attributes, read_timeout as statement query timeout; others appended to cs as connection string keywords for the driver,
+        //  e.g. Network=DBMSSOCN (SQL Server TCP)
+        for (auto& o : SplitOptions(options))
+        {
+            string k = o.first; transform(k.begin(), k.end(), k.begin(), ::tolower);
+            SQLULEN n = strtoul(o.second.c_str(), NULL, 10); SQLRETURN rc = SQL_SUCCESS;
+            if (k == "connect_timeout") rc = SQLSetConnectAttr(api.odbc.hDbc, SQL_ATTR_LOGIN_TIMEOUT, (SQLPOINTER) n, 0);
+            else if (k == "read_timeout") QueryTimeout = n;
+            else if (k == "net_buffer_length") rc = SQLSetConnectAttr(api.odbc.hDbc, SQL_ATTR_PACKET_SIZE, (SQLPOINTER) n, 0);
+            else cs += o.first + "=" + o.second + ";";
+            if (rc == SQL_ERROR) {ODBC_ERROR(SQL_HANDLE_DBC, api.odbc.hDbc, o.first + "=" + o.second); return -1;}
+        }
+        return 0;
+    }
+#endif
 
-    LvDbLib(string ConnectionString, string user, string pw, string db, u_int16_t t) { //  contructor and open connection
+    LvDbLib(string ConnectionString, string user, string pw, string db, u_int16_t t, string options = "") { //  contructor and open connection
         switch (t)
         {
         case NULL:
@@ -252,6 +491,7 @@ public:
                 SQLSetEnvAttr(api.odbc.hEnv, SQL_ATTR_ODBC_VERSION, (void*)SQL_OV_ODBC3, 0);
                 SQLAllocHandle(SQL_HANDLE_DBC, api.odbc.hEnv, &(api.odbc.hDbc));
                 string cs = ConnectionString;
+                if (OdbcOptions(options, cs)) break;
                 if (user != "") cs += "UID=" + user + ";";
                 if (pw != "") cs += "PWD=" + pw + ";";
                 SQLRETURN rc = SQLDriverConnect(api.odbc.hDbc, NULL, (SQLCHAR*)cs.c_str(), SQL_NTS, NULL, 0, NULL, SQL_DRIVER_COMPLETE);
@@ -263,9 +503,16 @@ public:
             case MySQL:
                 if ((api.my.con = mysql_init(NULL)) == NULL)
                     {errnum = mysql_errno(api.my.con); errstr = new string(mysql_error(api.my.con)); break;}
+#ifdef MARIADB_PACKAGE_VERSION
+                mysql_options(api.my.con, MYSQL_OPT_NONBLOCK, 0);   //  allow QueryAsync(), blocking calls work as before
+#endif
+               {unsigned int port = 0, on = 1; string socket = "/run/mysql/mysql.sock";
+                mysql_options(api.my.con, MYSQL_OPT_LOCAL_INFILE, &on);    //  BulkLoad(), the capability is negotiated at connect
+                if (MyOptions(options, port, socket)) break;
                 if (mysql_real_connect(api.my.con, ConnectionString.c_str(),
-                    user.c_str(), pw.c_str(), db.c_str(), 0, "/run/mysql/mysql.sock", 0) == NULL)
+                    user.c_str(), pw.c_str(), db.c_str(), port, socket.c_str(), 0) == NULL)
                     {errnum = mysql_errno(api.my.con); errstr = new string(mysql_error(api.my.con));}
+                else mysql_set_local_infile_handler(api.my.con, InfileInit, InfileRead, InfileEnd, InfileError, NULL);}  //  no client files
                 StrBufLen = 256; break;
 #endif
 
@@ -292,6 +539,9 @@ public:
     }
 
     ~LvDbLib() {  //  close connections and free handles
+        if (cursor.open) QueryClose();
+        if (blob.mode) BlobClose(true);
+        SetStmtCache(0);    //  close cached statements before the connection
         delete errstr; delete errdata;
         switch (type)
         {
@@ -328,8 +578,234 @@ public:
         }
     }
 
+    void StmtFree(void* h) {  //  close statement handle for good
+        switch (type)
+        {
+#ifdef MYAPI
+        case MySQL:
+            mysql_stmt_close((MYSQL_STMT*) h);
+            break;
+#endif
+#ifdef ODBCAPI
+        case ODBC:
+        case SqlServer:
+            SQLFreeHandle(SQL_HANDLE_STMT, (SQLHSTMT) h);
+            break;
+#endif
+        default:
+            break;
+        }
+    }
+
+    void StmtCachePut(string query, void* h) {  //  add newly prepared statement, evict least recently used
+        if (StmtCacheSize <= 0) return;
+        StmtCache.push_front({query, h}); StmtIndex[query] = StmtCache.begin(); StmtHandles.insert(h);
+        SetStmtCache(StmtCacheSize);
+    }
+
+    void* StmtCacheGet(string query) {  //  cached statement for SQL text, NULL if not cached
+        auto it = StmtIndex.find(query);
+        if (it == StmtIndex.end()) {StmtMisses++; return NULL;}
+        StmtHits++; StmtCache.splice(StmtCache.begin(), StmtCache, it->second);
+        return it->second->h;
+    }
+
+    void SetStmtCache(int size) {  //  set cache capacity, closing statements that no longer fit
+        StmtCacheSize = size;
+        while ((int) StmtCache.size() > (size > 0 ? size : 0))
+        {
+            StmtIndex.erase(StmtCache.back().query); StmtHandles.erase(StmtCache.back().h);
+            StmtFree(StmtCache.back().h); StmtCache.pop_back();
+        }
+    }
+
+    static vector<string> SqlTables(const string& sql) {  //  words after FROM, JOIN, INTO, UPDATE and TABLE up to the next clause,
+        //  lowercase, without schema and quotes; a rough scan that may also report aliases and literals, which only costs cache hits
+        static const unordered_set<string> start = {"from", "join", "straight_join", "into", "update", "table"},
+            stop = {"where", "group", "order", "limit", "having", "union", "on", "using", "set", "values", "value", "select",
+                    "partition", "window", "for", "lock", "with", "inner", "left", "right", "cross", "natural"};
+        vector<string> tables; string w; bool in = false;
+        for (size_t k = 0; k <= sql.length(); k++)
+        {
+            char c = (k < sql.length() ? sql[k] : ' ');
+            if (isalnum((uChar) c) || c == '_' || c == '$') {w += (char) tolower((uChar) c); continue;}
+            if (c == '.') {w.clear(); continue;}    //  schema.table
+            if (c == '`' || c == '"' || c == '[' || c == ']' || w.empty()) continue;
+            if (start.count(w)) in = true;
+            else if (stop.count(w)) in = false;
+            else if (in) tables.push_back(w);
+            w.clear();
+        }
+        return tables;
+    }
+
+    void ResultErase(list<tCachedResult>::iterator it) {
+        ResultCacheBytes -= it->bytes; ResultIndex.erase(it->key); ResultCache.erase(it);
+    }
+
+    int ResultCacheGet(const string& key, ResultSetHdl results) {  //  unexpired cached result into "results", return rows; -1 if not cached
+        if (ResultTtlMs <= 0) return -1;
+        auto it = ResultIndex.find(key);
+        if (it == ResultIndex.end()) {ResultMisses++; return -1;}
+        tCachedResult& r = *it->second;
+        if (chrono::steady_clock::now() >= r.expires) {ResultErase(it->second); ResultMisses++; return -1;}
+        if (DSSetHandleSize(results, offsetof(ResultSet, elt) + r.end.size() * sizeof(LStrHandle)) != mgNoErr) return -1;
+        for (size_t k = 0, b = 0; k < r.end.size(); b = r.end[k++])
+            (**results).elt[k] = LVStr(&r.data[b], r.end[k] - b);
+        (**results).dimSizes[0] = r.rows; (**results).dimSizes[1] = r.cols;
+        ResultHits++; ResultCache.splice(ResultCache.begin(), ResultCache, it->second);
+        errnum = 0; return r.rows;
+    }
+
+    void ResultCachePut(const string& key, const string& query, ResultSetHdl results, int rows) {  //  keep copy of result, evict least recently used
+        if (ResultTtlMs <= 0) return;
+        auto it = ResultIndex.find(key); if (it != ResultIndex.end()) ResultErase(it->second);
+        tCachedResult r; r.key = key; r.rows = rows; r.cols = (**results).dimSizes[1]; r.tables = SqlTables(query);
+        r.expires = chrono::steady_clock::now() + chrono::milliseconds(ResultTtlMs);
+        size_t n = (size_t) rows * r.cols; r.end.resize(n);
+        for (size_t k = 0; k < n; k++)
+            {LStrHandle c = (**results).elt[k]; r.data.append(LStrBuf(c), LStrLen(c)); r.end[k] = r.data.length();}
+        r.bytes = sizeof(r) + 2 * key.length() + r.data.length() + n * sizeof(uint32_t);
+        for (auto& t : r.tables) r.bytes += sizeof(t) + t.length();
+        if (r.bytes > ResultCacheMax) return;   //  would push out everything else
+        ResultCacheBytes += r.bytes; ResultCache.push_front(move(r)); ResultIndex[key] = ResultCache.begin();
+        while (ResultCacheBytes > ResultCacheMax) ResultErase(prev(ResultCache.end()));
+    }
+
+    void ResultInvalidate(const string& sql) {  //  drop cached results reading a table "sql" may write, all if it names none
+        if (ResultCache.empty()) return;
+        vector<string> w = SqlTables(sql);
+        for (auto it = ResultCache.begin(); it != ResultCache.end(); )
+        {
+            bool hit = w.empty();
+            for (auto& t : it->tables) if (find(w.begin(), w.end(), t) != w.end()) hit = true;
+            auto next = std::next(it); if (hit) ResultErase(it); it = next;
+        }
+    }
+
+    void SetResultCache(int ttl, int MaxKB) {  //  set result lifetime (0 disables and clears cache) and memory cap
+        ResultTtlMs = ttl; if (MaxKB >= 0) ResultCacheMax = (size_t) MaxKB << 10;
+        while (!ResultCache.empty() && (ttl <= 0 || ResultCacheBytes > ResultCacheMax)) ResultErase(prev(ResultCache.end()));
+    }
+
+#ifdef MYAPI
+    MYSQL_STMT* MyPrepare(string query, bool cache = true) {  //  prepared statement from cache, else prepare and cache it; NULL on error
+        MYSQL_STMT* stmt;   //  "cache" false prepares a statement of the caller's own, closed by StmtClose()
+        if (cache && (stmt = (MYSQL_STMT*) StmtCacheGet(query))) return stmt;
+        if (!(stmt = mysql_stmt_init(api.my.con))) {errnum = -1; errstr = new string("Out of memory"); return NULL;}
+        if (mysql_stmt_prepare(stmt, query.c_str(), query.length()))
+            {errnum = mysql_errno(api.my.con); errstr = new string(mysql_error(api.my.con));
+             mysql_stmt_close(stmt); return NULL;}
+        if (cache) StmtCachePut(query, stmt);
+        return stmt;
+    }
+
+    my_bool StmtClose(MYSQL_STMT* stmt) {  //  done with statement, cached ones only drop their results
+        if (!StmtHandles.count(stmt)) return mysql_stmt_close(stmt);
+#ifdef MARIADB_CLIENT_STMT_BULK_OPERATIONS
+        unsigned int n = 0; mysql_stmt_attr_set(stmt, STMT_ATTR_ARRAY_SIZE, &n);
+#endif
+        return mysql_stmt_free_result(stmt);
+    }
+
+    LStrHandle MyFetchColumn(MYSQL_STMT* stmt, MYSQL_BIND* bind, int col, unsigned long len) {  //  value longer than its bound buffer,
+        LStrHandle l;   //  read straight into a new LV string; NULL on error
+        if ((l = (LStrHandle) DSNewHClr(sizeof(int32) + len)) == NULL) {errnum = -1; errstr = new string("Out of memory"); return NULL;}
+        LvHandles++; LvBytes += len;
+        MYSQL_BIND b = *bind; unsigned long n = 0;
+        b.buffer = (*l)->str; b.buffer_length = len; b.length = &n;
+        if (mysql_stmt_fetch_column(stmt, &b, col, 0))
+            {errnum = mysql_stmt_errno(stmt); errstr = new string(mysql_stmt_error(stmt)); DSDisposeHandle(l); return NULL;}
+        (*l)->cnt = len; return l;
+    }
+
+    unsigned long MyBufLen(MYSQL_FIELD* field) {  //  bound buffer for string/BLOB column, longest value (after store) up to StrBufLen
+        return StrBufLen > 0 && field->max_length > (unsigned long) StrBufLen ? StrBufLen : field->max_length;
+    }
+#endif
+
+#ifdef ODBCAPI
+    SQLHSTMT OdbcPrepare(string query, bool cache = true) {  //  prepared statement from cache, else prepare and cache it; NULL on error
+        SQLHSTMT hStmt;     //  "cache" false prepares a statement of the caller's own, freed by StmtClose()
+        if (cache && (hStmt = (SQLHSTMT) StmtCacheGet(query))) return hStmt;
+        if (SQLAllocHandle(SQL_HANDLE_STMT, api.odbc.hDbc, &hStmt) == SQL_ERROR)
+            {ODBC_ERROR(SQL_HANDLE_DBC, api.odbc.hDbc, query); return NULL;}
+        StmtTimeout(hStmt);
+        if (SQLPrepare(hStmt, (SQLCHAR*)query.c_str(), SQL_NTS) == SQL_ERROR)
+            {ODBC_ERROR(SQL_HANDLE_STMT, hStmt, query);
+             SQLFreeHandle(SQL_HANDLE_STMT, hStmt); return NULL;}
+        if (cache) StmtCachePut(query, hStmt);
+        return hStmt;
+    }
+
+    SQLRETURN StmtClose(SQLHSTMT hStmt) {  //  done with statement, cached ones are closed, unbound and kept
+        if (!StmtHandles.count(hStmt)) return SQLFreeHandle(SQL_HANDLE_STMT, hStmt);
+        SQLFreeStmt(hStmt, SQL_CLOSE); SQLFreeStmt(hStmt, SQL_UNBIND); SQLFreeStmt(hStmt, SQL_RESET_PARAMS);
+        SQLSetStmtAttr(hStmt, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER) 1, 0);     //  GetResults() block cursor
+        SQLSetStmtAttr(hStmt, SQL_ATTR_ROWS_FETCHED_PTR, NULL, 0); SQLSetStmtAttr(hStmt, SQL_ATTR_ROW_STATUS_PTR, NULL, 0);
+        return SQLSetStmtAttr(hStmt, SQL_ATTR_PARAMSET_SIZE, (SQLPOINTER) 1, 0);
+    }
+
+    SQLLEN OdbcBufLen(SQLHSTMT hStmt, SQLUSMALLINT col, int t) {  //  bound buffer for string/BLOB column from its octet length,
+        if (StrBufLen <= 0) return 0;   //  0 if unknown or over StrBufLen, read with SQLGetData() instead
+        SQLLEN octets = 0;
+        if (SQLColAttribute(hStmt, col, SQL_DESC_OCTET_LENGTH, NULL, 0, NULL, &octets) == SQL_ERROR || octets <= 0) return 0;
+        octets += (t == String ? 1 : 0);    //  SQL_C_CHAR terminator
+        return octets <= StrBufLen ? octets : 0;
+    }
+
+    SQLRETURN OdbcGetData(SQLHSTMT hStmt, SQLUSMALLINT col, int t, string& val, bool& null) {  //  read unbound string/BLOB column
+        string buf(StrBlobLen > 0 ? StrBlobLen : 4096, (char) 0); SQLLEN len = 0; SQLRETURN rc;    //  in StrBlobLen chunks
+        SQLLEN chunk = buf.length() - (t == String ? 1 : 0);   //  SQL_C_CHAR chunks are null-terminated
+        val.clear(); null = false;
+        while ((rc = SQLGetData(hStmt, col, (t == String ? SQL_C_CHAR : SQL_C_BINARY), (char*) buf.c_str(), buf.length(), &len)) != SQL_NO_DATA)
+        {
+            if (rc == SQL_ERROR) return rc;
+            if (len == SQL_NULL_DATA) {null = true; break;}
+            val.append(buf, 0, (len == SQL_NO_TOTAL || len > chunk) ? chunk : len);
+            if (rc == SQL_SUCCESS) break;   //  last chunk
+        }
+        return SQL_SUCCESS;
+    }
+#endif
+
+    int Ping() {  //  cheap check that the connection is still alive, 0 if so
+        errnum = 0;
+        switch (type)
+        {
+#ifdef MYAPI
+        case MySQL:
+            if (api.my.con == NULL) { errnum = -1; errstr = new string("Connection closed"); return -1; }
+            if (mysql_ping(api.my.con)) MYSQL_EXIT();
+            break;
+#endif
+
+#ifdef ODBCAPI
+        case ODBC:
+        case SqlServer:
+           {if (api.odbc.hDbc == NULL) { errnum = -1; errstr = new string("Connection closed"); return -1; }
+            SQLUINTEGER dead = SQL_CD_TRUE;
+            SQLGetConnectAttr(api.odbc.hDbc, SQL_ATTR_CONNECTION_DEAD, &dead, 0, NULL);
+            if (dead != SQL_CD_FALSE) { errnum = -1; errstr = new string("Connection lost"); return -1; }}
+            break;
+#endif
+
+#ifdef MYCPPAPI
+        case MySQLpp:
+            if (api.mycpp.con == NULL || !api.mycpp.con->isValid())
+                { errnum = -1; errstr = new string("Connection lost"); return -1; }
+            break;
+#endif
+
+        default:
+            errnum = -1; errstr = new string("Unsupported RDBMS");
+            break;
+        }
+        return errnum;
+    }
+
     int SetSchema(string schema) {  //  set DB schema
-        errnum = 0; errdata = new string(schema);
+        errnum = 0; errdata = new string(schema); ResultInvalidate("");
         if (schema.length() < 1) { errstr = new string("Schema string may not be blank"); return -1; }
         switch (type)
         {
@@ -369,9 +845,19 @@ public:
         return errnum;
     }
 
+    bool Busy(const string& query) {  //  connection held by an open cursor or BLOB query, a statement now would get "Commands out of sync"
+        if (cursor.open) errstr = new string("Connection has an open query, use QueryClose");
+        else if (blob.mode == 2) errstr = new string("Connection has an open BLOB query, use BlobReadClose");
+        else if (blob.mode == 1 && type != MySQL) errstr = new string("Connection has an open BLOB write, use BlobWriteEnd");  //  ODBC SQL_NEED_DATA
+        else return false;
+        errnum = -1; delete errdata; errdata = new string(query); return true;
+    }
+
     int Query(string query, int cols) {  //  run query against connection and put results in res
         errnum = -1; errdata = new string(query);
         if (query.length() < 1) { errstr = new string("Query string may not be blank"); return -1; }
+        if (Busy(query)) return -1;
+        auto t0 = chrono::steady_clock::now(); stats.Count(tStats::Query, tStats::BytesOut, query.length());
         switch (type)
         {
         case NULL:
@@ -380,10 +866,10 @@ public:
 #ifdef MYAPI
         case MySQL:
             if (api.my.con == NULL) { errstr = new string("Connection closed"); return -1; }
-            if (!(api.my.stmt = mysql_stmt_init(api.my.con)))
-                {errnum = -1; errstr = new string("Out of memory"); return -1;}
-            if (mysql_stmt_prepare(api.my.stmt, query.c_str(), query.length())) MYSQL_EXIT()
+            if (!(api.my.stmt = MyPrepare(query))) return -1;
+            stats.Time(tStats::Query, tStats::Prepare, t0);
             if (mysql_stmt_execute(api.my.stmt)) MYSQL_EXIT();
+            stats.Time(tStats::Query, tStats::Exec, t0);
             errnum = 0; return 0;
             break;
 #endif
@@ -392,13 +878,12 @@ public:
         case ODBC:
         case SqlServer:
             {
-            int rc;
-            rc = SQLAllocHandle(SQL_HANDLE_STMT, api.odbc.hDbc, &(api.odbc.hStmt));
-            if (rc == SQL_ERROR) {ODBC_ERROR(SQL_HANDLE_DBC, api.odbc.hDbc, query); return -1;}
-            rc = SQLExecDirect(api.odbc.hStmt, (SQLCHAR*)query.c_str(), SQL_NTS);
-            if (rc == SQL_ERROR)
+            if (!(api.odbc.hStmt = OdbcPrepare(query))) return -1;
+            stats.Time(tStats::Query, tStats::Prepare, t0);
+            if (SQLExecute(api.odbc.hStmt) == SQL_ERROR)
                 {ODBC_ERROR(SQL_HANDLE_STMT, api.odbc.hStmt, query);
-                 SQLFreeHandle(SQL_HANDLE_STMT, api.odbc.hStmt); return -1;}
+                 StmtClose(api.odbc.hStmt); return -1;}
+            stats.Time(tStats::Query, tStats::Exec, t0);
             return 0;
             }
             break;
@@ -427,8 +912,10 @@ public:
     }
 
     int Execute(string query) {  //  run query against connection and return num rows affected
-        errnum = 0; errdata = new string(query); int ans = 0;
+        errnum = 0; errdata = new string(query); int ans = 0; ResultInvalidate(query);
         if (query.length() < 1) { errstr = new string("Query string may not be blank"); return -1; }
+        if (Busy(query)) return -1;
+        auto t0 = chrono::steady_clock::now(); stats.Count(tStats::Execute, tStats::BytesOut, query.length());
         switch (type)
         {
         case NULL:
@@ -441,6 +928,7 @@ public:
                 {errnum = mysql_errno(api.my.con); errstr = new string(mysql_error(api.my.con)); ans = -1;}
             else
                 {errnum = 0; ans = mysql_affected_rows(api.my.con);}
+            stats.Time(tStats::Execute, tStats::Exec, t0);
             break;
 #endif
 
@@ -450,10 +938,12 @@ public:
             if (!api.odbc.hDbc) { errnum = -1; errstr = new string("No DB connection"); return -1; }
             if (SQLAllocHandle(SQL_HANDLE_STMT, api.odbc.hDbc, &(api.odbc.hStmt)) == SQL_ERROR)
                 {ODBC_ERROR(SQL_HANDLE_STMT, api.odbc.hStmt, "SQLAllocHandle"); return -1;}
+            StmtTimeout(api.odbc.hStmt);
             int rc; rc = SQLExecDirect(api.odbc.hStmt, (SQLCHAR*)query.c_str(), SQL_NTS);
             if (rc == SQL_ERROR) {ODBC_ERROR(SQL_HANDLE_STMT, api.odbc.hStmt, query); ans = -1;}
             else SQLRowCount(api.odbc.hStmt, (SQLLEN*)&ans);
-            SQLFreeHandle(SQL_HANDLE_STMT, api.odbc.hStmt);
+            stats.Time(tStats::Execute, tStats::Exec, t0);
+            StmtClose(api.odbc.hStmt);
             break;
 #endif
 
@@ -478,657 +968,2903 @@ public:
         return ans;
     }
 
-    int UpdatePrepared(string query, string v[], int rows, int cols, uint16_t ColsTD[]) {  //  UPDATE/INSERT etc with flattened LabVIEW data
-        errnum = -1; errdata = new string(query); int i, j, ans = -1;
-        if (query.length() < 1) { errstr = new string("Query string may not be blank"); return -1; }
-        if (rows * cols == 0) { errstr = new string("No data to post"); return -1; }
+    int ExecuteBatch(vector<string>& queries, vector<int32>& counts, int32* failed) {  //  run statements in one round trip,
+        //  rows affected per statement in "counts" (-1 if not run), index of first failing statement in "failed"; return total rows
+        int n = queries.size(), k = 0, ans = 0; string batch;
+        counts.assign(n, -1); *failed = -1; errnum = 0;
+        if (Busy(n ? queries[0] : "")) return -1;
+        for (auto& q : queries)     //  one statement per element, trailing terminator optional
+        {
+            ResultInvalidate(q);
+            size_t e = q.find_last_not_of(" \t\r\n;");
+            if (e == string::npos) { errdata = new string(q); errstr = new string("Query string may not be blank"); errnum = -1; *failed = &q - &queries[0]; return -1; }
+            batch += (batch.length() ? ";\n" : "") + q.substr(0, e + 1);
+        }
+        errdata = new string(batch);
+        if (n == 0) return 0;
+        auto t0 = chrono::steady_clock::now(); stats.Count(tStats::Execute, tStats::BytesOut, batch.length());
         switch (type)
         {
-        case NULL:
-            break;
-
 #ifdef MYAPI
-#define CASE(xTD, cType, sType) case  xTD:\
-    union { cType f; char c[sizeof(cType)]; } xTD ## _;\
-    memcpy(xTD ## _.c, val.c_str(), sizeof(cType));\
-    bind[i].buffer_type = sType; bind[i].buffer = (char*)&xTD ## _.f;\
-    bind[i].is_null = 0; bind[i].length = 0;  //  numerics don't need length
-
-
-        case MySQL:
-            if (api.my.con == NULL) { errstr = new string("Connection closed"); return -1; }
-            api.my.stmt = mysql_stmt_init(api.my.con);
-            if (api.my.stmt == NULL) { errstr = new string("Out of memory"); return -1; }
-            if (mysql_stmt_prepare(api.my.stmt, query.c_str(), query.length()))
-            {
-                errnum = mysql_errno(api.my.con); errstr = new string(mysql_error(api.my.con));
-                mysql_stmt_close(api.my.stmt); return -1;
-            }
-            MYSQL_BIND* bind; bind = new MYSQL_BIND[cols];
-
-            for (j = 0; j < rows; j++)
+        case MySQL: {
+            if (api.my.con == NULL) { errnum = -1; errstr = new string("Connection closed"); return -1; }
+            //  multi-statements only for this call, Execute() keeps rejecting stacked queries
+            if (mysql_set_server_option(api.my.con, MYSQL_OPTION_MULTI_STATEMENTS_ON)) MYSQL_EXIT();
+            int rc = mysql_real_query(api.my.con, batch.c_str(), batch.length());
+            while (!rc)     //  one result per statement, the server stops at the first error
             {
-                for (i = 0; i < cols; i++)
-                {
-                    string val = v[j * cols + i];
-                    switch (ColsTD[i])
-                    {
-                    case U8:
-                    case Boolean:
-                    CASE(I8, char, MYSQL_TYPE_TINY)
-                        break;
-                    case U16:
-                    CASE(I16, short, MYSQL_TYPE_SHORT)
-                        break;
-                    case U32:
-                    CASE(I32, int, MYSQL_TYPE_LONG)
-                        break;
-                    CASE(SGL, float, MYSQL_TYPE_FLOAT)
-                        break;
-                    CASE(DBL, double, MYSQL_TYPE_DOUBLE)
-                        break;
-                    case String:
-                    case Array: //  how we pass BLOB data (not null-terminated str)
-                        char* str_data; str_data = (char*) val.c_str();
-                        long unsigned str_length; str_length = val.length();
-                        bind[i].buffer_type = (ColsTD[i] != Array? MYSQL_TYPE_STRING: MYSQL_TYPE_BLOB);
-                        bind[i].buffer = (char*)str_data;
-                        bind[i].buffer_length = str_length; bind[i].is_null = 0; bind[i].length = &str_length;
-                        break;
-                    default:
-                        {errstr = new string("Data type (" + to_string(ColsTD[i]) + ") not supported"); return -1; }
-                        break;
-                    }
-                }
-                if ((errnum = mysql_stmt_bind_param(api.my.stmt, bind)) != 0)
-                    {errstr = new string(mysql_error(api.my.con)); mysql_stmt_close(api.my.stmt); return -1;}
-                if (mysql_stmt_execute(api.my.stmt) != 0)
-                    {errnum = mysql_errno(api.my.con); errstr = new string(mysql_error(api.my.con));
-                     mysql_stmt_close(api.my.stmt); return -1;}
+                if (mysql_field_count(api.my.con))  //  statement returned rows, discard them
+                    {MYSQL_RES* res = mysql_store_result(api.my.con); if (res) mysql_free_result(res);}
+                ans += (counts[k] = mysql_affected_rows(api.my.con)); k++;
+                if ((rc = mysql_next_result(api.my.con)) < 0) break;    //  -1 no more results
             }
-            ans = j; mysql_stmt_close(api.my.stmt); delete bind;
-            {errnum = 0; errstr = new string("SUCCESS"); return ans; }
-            break;
-#undef CASE
+            if (rc > 0) {errnum = mysql_errno(api.my.con); errstr = new string(mysql_error(api.my.con)); *failed = k;}
+            mysql_set_server_option(api.my.con, MYSQL_OPTION_MULTI_STATEMENTS_OFF);
+            stats.Time(tStats::Execute, tStats::Exec, t0);
+            break;}
 #endif
 
 #ifdef ODBCAPI
-#define CASE(LVt, SQLt, SQLCt, Ct) \
-    case LVt:\
-        union { Ct f; char c[sizeof(Ct)]; } LVt ## _;\
-        memcpy(LVt ## _.c, (*val).c_str(), sizeof(Ct));\
-        rc = SQLBindParameter(api.odbc.hStmt, i + 1, SQL_PARAM_INPUT, \
-            SQLt, SQLCt, sizeof(Ct), 0, &LVt ## _.f, 0, (SQLLEN*) &cbValue);\
-        if (rc == SQL_ERROR) \
-            {ODBC_ERROR(SQL_HANDLE_STMT, api.odbc.hStmt, query);\
-             SQLFreeHandle(SQL_HANDLE_STMT, api.odbc.hStmt); return -1;}
-
         case ODBC:
-        case SqlServer:
-            if (api.odbc.hDbc == NULL) { errnum = -1; errstr = new string("Connection closed"); return -1; }
+        case SqlServer: {
+            if (!api.odbc.hDbc) { errnum = -1; errstr = new string("No DB connection"); return -1; }
             if (SQLAllocHandle(SQL_HANDLE_STMT, api.odbc.hDbc, &(api.odbc.hStmt)) == SQL_ERROR)
                 {ODBC_ERROR(SQL_HANDLE_STMT, api.odbc.hStmt, "SQLAllocHandle"); return -1;}
-            int rc; rc = SQLPrepare(api.odbc.hStmt, (SQLCHAR*)query.c_str(), SQL_NTS);
-            if (rc == SQL_ERROR)
-                {ODBC_ERROR(SQL_HANDLE_STMT, api.odbc.hStmt, query);
-                 SQLFreeHandle(SQL_HANDLE_STMT, api.odbc.hStmt); return -1;}
-            for (j = 0; j < rows; j++)
+            StmtTimeout(api.odbc.hStmt);
+            SQLUINTEGER bs = 0; SQLGetInfo(api.odbc.hDbc, SQL_BATCH_SUPPORT, &bs, sizeof(bs), NULL);
+            SQLRETURN rc; SQLLEN rows;
+            if (bs & SQL_BS_ROW_COUNT_EXPLICIT)     //  driver runs the batch and returns a row count per statement
             {
-                for (i = 0; i < cols; i++)
+                rc = SQLExecDirect(api.odbc.hStmt, (SQLCHAR*)batch.c_str(), SQL_NTS);
+                while (rc != SQL_ERROR && k < n)
                 {
-                    SQLINTEGER cbValue; 
-                    string *val = &v[j * cols + i];
-                    switch (ColsTD[i]) {    //  NOTE: We may want to use SQL_C_DEFAULT instead of specific C type
-                        CASE(Boolean, SQL_C_BIT, SQL_BIT, u_char)
-                            break;
-                        CASE(U8, SQL_C_UTINYINT, SQL_TINYINT, u_char)
-                            break;
-                        CASE(I8, SQL_C_STINYINT, SQL_TINYINT, char)
-                            break;
-                        CASE(U16, SQL_C_USHORT, SQL_SMALLINT, int16)
-                            break;
-                        CASE(I16, SQL_C_SSHORT, SQL_SMALLINT, uInt16)
-                            break;
-                        CASE(U32, SQL_C_ULONG, SQL_INTEGER, int32)
-                            break;
-                        CASE(I32, SQL_C_SLONG, SQL_INTEGER, uint32_t)
-                            break;
-                        CASE(SGL, SQL_C_FLOAT, SQL_REAL, float)
-                            break;
-                        CASE(DBL, SQL_C_DOUBLE, SQL_DOUBLE, double)
-                            break;
-                        case String:
-                            cbValue = SQL_NTS;
-                            rc = SQLBindParameter(api.odbc.hStmt, i + 1, SQL_PARAM_INPUT,SQL_C_CHAR, 
-                                SQL_LONGVARCHAR, (*val).length(), 0, (SQLCHAR*) &((*val)[0]), (*val).length(), (SQLLEN*) &cbValue);
-                            if (rc == SQL_ERROR)
-                                {ODBC_ERROR(SQL_HANDLE_STMT, api.odbc.hStmt, query);
-                                    SQLFreeHandle(SQL_HANDLE_STMT, api.odbc.hStmt); return -1;}
-                            break;
-                        case Array: //  how we pass binary data (not SQL_NTS/null-terminated str)
-                            cbValue = (*val).length();
-                            rc = SQLBindParameter(api.odbc.hStmt, i + 1, SQL_PARAM_INPUT,SQL_C_BINARY, 
-                                SQL_VARBINARY, (*val).length(), 0, (SQLCHAR*) &((*val)[0]), (*val).length(), (SQLLEN*) &cbValue);
-                            if (rc == SQL_ERROR)
-                                {ODBC_ERROR(SQL_HANDLE_STMT, api.odbc.hStmt, query);
-                                    SQLFreeHandle(SQL_HANDLE_STMT, api.odbc.hStmt); return -1;}
-                            break;
-                        default:
-                            {errstr = new string("Data type (" + to_string(ColsTD[i]) + ") not supported"); return -1; }
-                            break;
-                    }
+                    rows = -1; SQLRowCount(api.odbc.hStmt, &rows); ans += (counts[k] = rows); k++;
+                    if ((rc = SQLMoreResults(api.odbc.hStmt)) == SQL_NO_DATA) break;
                 }
-                rc = SQLExecute(api.odbc.hStmt);
-                if (rc == SQL_ERROR)
-                    {ODBC_ERROR(SQL_HANDLE_STMT, api.odbc.hStmt, query);
-                     SQLFreeHandle(SQL_HANDLE_STMT, api.odbc.hStmt); return -1;}
             }
-            SQLFreeHandle(SQL_HANDLE_STMT, api.odbc.hStmt); ans = j;
-            break;
-#undef CASE
-#endif
-
-#ifdef MYCPPAPI
-        case MySQLpp:
-            if (api.mycpp.con == NULL) { errnum = -1; errstr = new string("Connection closed"); return -1; }
-            try {
-                sql::PreparedStatement* pstmt; pstmt = api.mycpp.con->prepareStatement(query);
-                for (j = 0; j < rows; j++)
+            else    //  no batches, one statement per round trip on the same handle
+                for (rc = SQL_SUCCESS; k < n; k++)
                 {
-                    for (i = 0; i < cols; i++)
-                    {
-                        string val = v[j * cols + i];
-                        switch (ColsTD[i])
-                        {
-                        case I8:
-                            union { char f; char c[sizeof(char)]; } I8_;
-                            I8_.c[0] = val[0]; pstmt->setInt(i + 1, I8_.f);
-                            break;
-                        case U8:
-                        case Boolean:
-                            union { u_char f; char c[sizeof(char)]; } U8_;
-                            U8_.c[0] = val[0]; pstmt->setUInt(i + 1, U8_.f);
-                            break;
-                        case I32:
-                            union { int f; char c[sizeof(int)]; } I32_;
-                            memcpy(I32_.c, val.c_str(), sizeof(int)); pstmt->setInt(i + 1, I32_.f);
-                            break;
-                        case U32:
-                            union { uint f; char c[sizeof(uint)]; } U32_;
-                            memcpy(U32_.c, val.c_str(), sizeof(int)); pstmt->setInt(i + 1, U32_.f);
-                            break;
-                        case DBL:
-                            union { double f; char c[sizeof(double)]; } DBL_;
-                            memcpy(DBL_.c, val.c_str(), sizeof(double)); pstmt->setDouble(i + 1, DBL_.f);
-                            break;
-                        case String:
-                            pstmt->setString(i + 1, val);
-                            break;
-                        case Array: //  how we pass BLOB data (not null-terminated str)
-                            std::stringstream *stream; stream->write(& val[0], val.length());
-                            pstmt->setBlob(i + 1, stream);
-                            break;
-                        default:
-                            break;
-                        }
-                    }
-                    pstmt->executeUpdate();
+                    if ((rc = SQLExecDirect(api.odbc.hStmt, (SQLCHAR*)queries[k].c_str(), SQL_NTS)) == SQL_ERROR) break;
+                    rows = -1; SQLRowCount(api.odbc.hStmt, &rows); ans += (counts[k] = rows);
+                    SQLFreeStmt(api.odbc.hStmt, SQL_CLOSE);
                 }
-                delete pstmt; return j;
-            }
-            catch (sql::SQLException& e) {
-                errstr = new string(e.what()); errdata = new string(query);
-                errnum = e.getErrorCode();  return -1;
-            }          break;
+            if (rc == SQL_ERROR) {ODBC_ERROR(SQL_HANDLE_STMT, api.odbc.hStmt, k < n ? queries[k] : batch); *failed = k;}
+            stats.Time(tStats::Execute, tStats::Exec, t0);
+            StmtClose(api.odbc.hStmt);
+            break;}
 #endif
 
         default:
-            errstr = new string("Unsupported RDBMS"); return -1;
+            errnum = -1; errstr = new string("Batches not supported for this RDBMS");
             break;
         }
-        return ans;
+        return errnum ? -1 : ans;
     }
 
-    int GetResults(int *rows, int cols, TypesHdl types, ResultSetHdl results) {  //  return results as LV flattened strings
-        errnum = 0; int rc;
-        int row = 0; //  row number
-        vector<long> DataLen(cols, 0);
-        vector<string> str(cols, string(StrBufLen, (char) 0));
-        vector<variant<VAR_TYPES>> res(cols); // result set. MSVC has heartburn with initialization "(cols, (char) 0)"
-
-        if (*rows > 0)  //  we know the number of rows before hand, otherwise we need to dynamically allocate on fetches
-           {DSSetHandleSize(results, sizeof(int32) * 2 + (*rows) * cols * sizeof(LStrHandle));
-            (**results).dimSizes[0] = *rows; (**results).dimSizes[1] = cols;}
-
+    int SetAutocommit(bool on) {  //  switch autocommit, off keeps statements in one transaction until EndTrans()
+        errnum = 0;
         switch (type)
         {
-        case NULL:
+#ifdef MYAPI
+        case MySQL:
+            if (api.my.con == NULL) { errnum = -1; errstr = new string("Connection closed"); return -1; }
+            if (mysql_autocommit(api.my.con, on)) MYSQL_EXIT();
             break;
+#endif
 
-#ifdef MYAPI
-        case MySQL: {
-            if (!(api.my.query_results = mysql_stmt_result_metadata(api.my.stmt))) //  Fetch result set meta information
-                MYSQL_EXIT();
-            if (cols != mysql_num_fields(api.my.query_results))
-                {errnum = -1; errstr = new string("Data column number mismatch"); return false;}
+#ifdef ODBCAPI
+        case ODBC:
+        case SqlServer:
+            if (!api.odbc.hDbc) { errnum = -1; errstr = new string("No DB connection"); return -1; }
+            if (SQLSetConnectAttr(api.odbc.hDbc, SQL_ATTR_AUTOCOMMIT, (SQLPOINTER) (on ? SQL_AUTOCOMMIT_ON : SQL_AUTOCOMMIT_OFF), 0) == SQL_ERROR)
+                {ODBC_ERROR(SQL_HANDLE_DBC, api.odbc.hDbc, "SQL_ATTR_AUTOCOMMIT"); return -1;}
+            break;
+#endif
 
-            /* Fetch result set meta information */
-            MYSQL_FIELD* fields; fields = mysql_fetch_fields(api.my.query_results);
+#ifdef MYCPPAPI
+        case MySQLpp:
+            if (api.mycpp.con == NULL) { errnum = -1; errstr = new string("Connection closed"); return -1; }
+            try { api.mycpp.con->setAutoCommit(on); }
+            catch (sql::SQLException& e) { errstr = new string(e.what()); errnum = e.getErrorCode(); return -1; }
+            break;
+#endif
 
-            vector<unsigned long> length(cols, 0);
-            vector<my_bool*> error(cols), is_null(cols);
-            api.my.bind = new MYSQL_BIND[cols];
+        default:
+            errnum = -1; errstr = new string("Transactions not supported for this RDBMS");
+            break;
+        }
+        return errnum;
+    }
+
+    int EndTrans(bool commit) {  //  commit or roll back the statements since the last EndTrans(), autocommit stays off
+        errnum = 0; if (!commit) ResultInvalidate("");  //  cached results may hold rows rolled back
+        switch (type)
+        {
+#ifdef MYAPI
+        case MySQL:
+            if (api.my.con == NULL) { errnum = -1; errstr = new string("Connection closed"); return -1; }
+            if (commit ? mysql_commit(api.my.con) : mysql_rollback(api.my.con)) MYSQL_EXIT();
+            break;
+#endif
+
+#ifdef ODBCAPI
+        case ODBC:
+        case SqlServer:
+            if (!api.odbc.hDbc) { errnum = -1; errstr = new string("No DB connection"); return -1; }
+            if (SQLEndTran(SQL_HANDLE_DBC, api.odbc.hDbc, commit ? SQL_COMMIT : SQL_ROLLBACK) == SQL_ERROR)
+                {ODBC_ERROR(SQL_HANDLE_DBC, api.odbc.hDbc, commit ? "SQL_COMMIT" : "SQL_ROLLBACK"); return -1;}
+            break;
+#endif
+
+#ifdef MYCPPAPI
+        case MySQLpp:
+            if (api.mycpp.con == NULL) { errnum = -1; errstr = new string("Connection closed"); return -1; }
+            try { if (commit) api.mycpp.con->commit(); else api.mycpp.con->rollback(); }
+            catch (sql::SQLException& e) { errstr = new string(e.what()); errnum = e.getErrorCode(); return -1; }
+            break;
+#endif
+
+        default:
+            errnum = -1; errstr = new string("Transactions not supported for this RDBMS");
+            break;
+        }
+        return errnum;
+    }
+
+    int Begin() {  //  open explicit transaction, ended by EndTransaction()
+        if (InTrans) { errnum = -1; errstr = new string("Transaction already open, use Commit or Rollback"); return -1; }
+        if (SetAutocommit(false)) return -1;
+        InTrans = true; return 0;
+    }
+
+    int EndTransaction(bool commit) {  //  commit or roll back explicit transaction and return to autocommit
+        if (!InTrans) { errnum = -1; errstr = new string("No open transaction, use Begin"); return -1; }
+        InTrans = false;
+        int rc = EndTrans(commit); int e = errnum; string* err = errstr; errstr = NULL;
+        if (rc && commit) { EndTrans(false); delete errstr; errstr = NULL; }  //  autocommit on would commit what the failed COMMIT left
+        SetAutocommit(true);    //  keep the commit/rollback error, if any
+        if (rc) { errnum = e; delete errstr; errstr = err; } else delete err;
+        return errnum ? -1 : 0;
+    }
+
+    enum RowStatus {RowSuccess = 0, RowError = 5, RowUnused = 7};  //  UpdatePrepared() per-row status, same values as ODBC SQL_PARAM_*
+
+    int UpdatePrepared(string query, LStrHandle v[], int rows, int cols, uint16_t ColsTD[], vector<uint16_t>* status = NULL) {  //  UpdateRows(), with group commit
+        if (Busy(query)) return -1;
+        ResultInvalidate(query);
+        if (InTrans || (CommitRows <= 0 && CommitMs <= 0) || rows * cols == 0) return UpdateRows(query, v, rows, cols, ColsTD, status);
+        //  autocommit would make every execute its own durable transaction; run the DataSet in one transaction instead,
+        //  committed every CommitRows rows and/or CommitMs ms. On error the rows since the last commit are rolled back
+        if (SetAutocommit(false)) return -1;
+        int slice = (CommitRows > 0 ? CommitRows : ParamSetSize > 0 ? ParamSetSize : rows), committed = 0, ans = 0, n;
+        if (status) status->assign(rows, RowUnused);
+        vector<uint16_t> st; auto tc = chrono::steady_clock::now();
+        for (int j = 0; j < rows; j += n)
+        {
+            n = min(slice, rows - j);
+            int r = UpdateRows(query, v + (size_t) j * cols, n, cols, ColsTD, status ? &st : NULL);
+            if (status) copy(st.begin(), st.end(), status->begin() + j);
+            if (r >= 0) ans += r;
+            auto now = chrono::steady_clock::now();
+            if (r >= 0 && (j + n == rows || (CommitRows > 0 && j + n - committed >= CommitRows) ||
+                (CommitMs > 0 && now - tc >= chrono::milliseconds(CommitMs))))
+                {if ((r = EndTrans(true)) == 0) {committed = j + n; tc = now;}}
+            if (r < 0)
+            {
+                int e = errnum; string* err = errstr; errstr = NULL;
+                EndTrans(false); SetAutocommit(true);
+                errnum = e; delete errstr; errstr = new string((err ? *err : "") + "; rows from " + to_string(committed) + " rolled back");
+                delete err;
+                if (status) for (int k = committed; k < j + n; k++) if ((*status)[k] != RowError) (*status)[k] = RowUnused;
+                return -1;
+            }
+        }
+        SetAutocommit(true);
+        return ans;
+    }
+
+    int UpdateRows(string query, LStrHandle v[], int rows, int cols, uint16_t ColsTD[], vector<uint16_t>* status = NULL,
+            bool select = false) {  //  UPDATE/INSERT etc with flattened LabVIEW data
+        //  "v" is the DataSet itself, strings and BLOBs are bound in place with explicit lengths (no copy, no terminator)
+        //  "select" runs a query with one row of parameters and leaves its results to GetResults(), see QueryPrepared()
+        errnum = -1; errdata = new string(query); int i, j, ans = -1, op = (select ? tStats::Query : tStats::Update);
+        if (query.length() < 1) { errstr = new string("Query string may not be blank"); return -1; }
+        if (rows * cols == 0) { errstr = new string("No data to post"); return -1; }
+        if (status) status->assign(rows, RowUnused);
+        auto t0 = chrono::steady_clock::now(); uint64_t out = query.length();
+        for (j = 0; j < rows * cols; j++) out += LStrLen(v[j]);
+        stats.Count(op, tStats::BytesOut, out);
+
+        //  EXT cells go as decimal text and timestamps as the API's date-time struct, converted here into LStr records
+        //  local to this call (8 byte aligned values), so the binding below takes them like any other cell
+        vector<string> rec; vector<LStr*> master; vector<LStrHandle> cells;
+        if (any_of(ColsTD, ColsTD + cols, [](uint16_t t) { return t == EXT || t == Timestamp; }))
+        {
+            for (j = 0; j < rows * cols; j++)
+            {
+                int t = ColsTD[j % cols]; if (t != EXT && t != Timestamp) continue;
+                string val = (t == EXT ? ExtText(v[j]) : TimeParam(v[j])); int32 cnt = val.length();
+                rec.push_back(string(sizeof(int32), (char) 0) + string((char*) &cnt, sizeof(cnt)) + val);
+            }
+            cells.assign(v, v + (size_t) rows * cols); master.resize(rec.size());
+            for (j = 0, i = 0; j < rows * cols; j++)
+            {
+                int t = ColsTD[j % cols]; if (t != EXT && t != Timestamp) continue;
+                master[i] = (LStr*) (&rec[i][0] + sizeof(int32)); cells[j] = &master[i]; i++;
+            }
+            v = &cells[0];
+        }
+        switch (type)
+        {
+        case NULL:
+            break;
+
+#ifdef MYAPI
+        case MySQL: {
+            if (api.my.con == NULL) { errstr = new string("Connection closed"); return -1; }
+            if (!(api.my.stmt = MyPrepare(query))) return -1;
+            stats.Time(op, tStats::Prepare, t0);
+            vector<MYSQL_BIND> bind(cols); memset(&bind[0], 0, cols * sizeof(MYSQL_BIND));
+            vector<int> size(cols, 0);
+#define CASE(xTD, cType, sType, uType) case  xTD:\
+            bind[i].buffer_type = sType; bind[i].is_unsigned = uType; size[i] = sizeof(cType);\
+            break;
 
-            for (int i = 0; i < cols; i++) {  //  bind buffers
-                api.my.bind[i].is_null = is_null[i]; api.my.bind[i].error = error[i];
-                api.my.bind[i].length = &length[i]; api.my.bind[i].buffer_type = fields[i].type;
-                switch (fields[i].type)
+            for (i = 0; i < cols; i++)
+            {
+                switch (ColsTD[i])
                 {
-                case MYSQL_TYPE_TINY:
-                    res[i] = (char) 0; api.my.bind[i].buffer = &(res[i]); break;
-                case MYSQL_TYPE_SHORT:
-                    res[i] = (short) 0; api.my.bind[i].buffer = &(res[i]); break;
-                case MYSQL_TYPE_LONG:
-                    res[i] = (long) 0; api.my.bind[i].buffer = &(res[i]); break;
-                case MYSQL_TYPE_FLOAT:
-                    res[i] = (float) 0; api.my.bind[i].buffer = &(res[i]); break;
-                case MYSQL_TYPE_DOUBLE:
-                    res[i] = (double) 0; api.my.bind[i].buffer = &(res[i]); break;
-                case MYSQL_TYPE_TINY_BLOB ... MYSQL_TYPE_STRING:
-                    if (StrBufLen > 0)
-                    {
-                        str[i] = string(StrBufLen, (char) 0);
-                        api.my.bind[i].buffer = (char*) str[i].c_str();
-                        api.my.bind[i].buffer_length = str[i].length();
-                    }
-                    else
-                       {api.my.bind[i].buffer = 0; api.my.bind[i].buffer_length = 0;}
+                CASE(Boolean, char, MYSQL_TYPE_TINY, 1)
+                CASE(U8, char, MYSQL_TYPE_TINY, 1)
+                CASE(I8, char, MYSQL_TYPE_TINY, 0)
+                CASE(U16, short, MYSQL_TYPE_SHORT, 1)
+                CASE(I16, short, MYSQL_TYPE_SHORT, 0)
+                CASE(U32, int, MYSQL_TYPE_LONG, 1)
+                CASE(I32, int, MYSQL_TYPE_LONG, 0)
+                CASE(U64, int64, MYSQL_TYPE_LONGLONG, 1)
+                CASE(I64, int64, MYSQL_TYPE_LONGLONG, 0)
+                CASE(SGL, float, MYSQL_TYPE_FLOAT, 0)
+                CASE(DBL, double, MYSQL_TYPE_DOUBLE, 0)
+                case Timestamp: //  MYSQL_TIME, array bound by pointer like strings
+                    bind[i].buffer_type = MYSQL_TYPE_DATETIME;
                     break;
-                default:
-                    delete api.my.bind;
-                    errnum = -1; errstr = new string("Unsupported MySQL type: " + to_string(fields[i].type));
-                    mysql_free_result(api.my.query_results); mysql_stmt_close(api.my.stmt);
-                    return -1;
+                case EXT:   //  decimal text, the server converts it to the column type
+                case String:
+                case Array: //  how we pass BLOB data (not null-terminated str)
+                    bind[i].buffer_type = (ColsTD[i] != Array? MYSQL_TYPE_STRING: MYSQL_TYPE_BLOB);
                     break;
+                default:
+                    errstr = new string("Data type (" + to_string(ColsTD[i]) + ") not supported");
+                    StmtClose(api.my.stmt); return -1;
                 }
             }
-            int k = 1;
-            if (mysql_stmt_attr_set(api.my.stmt, STMT_ATTR_UPDATE_MAX_LENGTH, &k)) MYSQL_EXIT();
-            if (mysql_stmt_store_result(api.my.stmt)) MYSQL_EXIT();
-#define CASE(xTD, cType) case  xTD:\
-            (**results).elt[row * cols + i] = LVStr((char*) &(res[i]), sizeof(cType));
+#undef CASE
+
+            //  MariaDB servers take a whole parameter array per execute (COM_STMT_BULK_EXECUTE),
+            //  others get the DataSet one row at a time
+            bool bulk; bulk = false;     //  bulk executes return no result set
+#ifdef MARIADB_CLIENT_STMT_BULK_OPERATIONS
+            unsigned long caps; caps = 0;
+            if (!select && !mariadb_get_infov(api.my.con, MARIADB_CONNECTION_EXTENDED_SERVER_CAPABILITIES, &caps))
+                bulk = (caps & (MARIADB_CLIENT_STMT_BULK_OPERATIONS >> 32)) != 0;
+#endif
+            unsigned int chunk, n; chunk = (!bulk ? 1 : ParamSetSize > 0 && ParamSetSize < rows ? ParamSetSize : rows);
+            vector<string> buf(cols);                                           //  numeric column arrays
+            vector<vector<char*>> ptr(cols, vector<char*>(chunk));              //  string/BLOB column arrays, point into DataSet
+            vector<vector<unsigned long>> len(cols, vector<unsigned long>(chunk));
 
-            if (StrBufLen == 0) {
-            for (int i = 0; i < cols; i++) {
-                switch (fields[i].type)
+            for (j = 0; j < rows; j += n)
+            {
+                n = ((unsigned) (rows - j) < chunk ? rows - j : chunk);
+                if (bulk && mysql_stmt_attr_set(api.my.stmt, STMT_ATTR_ARRAY_SIZE, &n))
+                    {errnum = mysql_stmt_errno(api.my.stmt); errstr = new string(mysql_stmt_error(api.my.stmt));
+                     StmtClose(api.my.stmt); return -1;}
+                for (i = 0; i < cols; i++)
                 {
-                case MYSQL_TYPE_TINY_BLOB ... MYSQL_TYPE_STRING:
-                    str[i] = string(fields[i].max_length, (char) 0);
-                    api.my.bind[i].buffer = (char*) str[i].c_str();
-                    api.my.bind[i].buffer_length = str[i].length();
-                    break;
-                default:
-                    break;
+                    if (size[i])    //  numerics don't need length
+                    {
+                        buf[i].assign((size_t) n * size[i], (char) 0);
+                        for (unsigned int k = 0; k < n; k++)
+                        {
+                            LStrHandle val = v[(j + k) * cols + i];
+                            memcpy(&buf[i][(size_t) k * size[i]], LStrBuf(val), min((int) LStrLen(val), size[i]));
+                        }
+                        bind[i].buffer = (char*) buf[i].c_str();
+                        continue;
+                    }
+                    for (unsigned int k = 0; k < n; k++)
+                        {ptr[i][k] = LStrBuf(v[(j + k) * cols + i]); len[i][k] = LStrLen(v[(j + k) * cols + i]);}
+                    if (bulk) bind[i].buffer = &ptr[i][0];  //  column-wise arrays of pointers to values
+                    else {bind[i].buffer = ptr[i][0]; bind[i].buffer_length = len[i][0];}
+                    bind[i].length = &len[i][0];
                 }
-            }}
-            if (mysql_stmt_bind_result(api.my.stmt, api.my.bind)) MYSQL_EXIT();
-            while ((rc = mysql_stmt_fetch(api.my.stmt)) != 1) {  //  Fetch all rows
-                if (rc == MYSQL_NO_DATA) break;
-                //  allocate another row
-                DSSetHandleSize(results, sizeof(int32) * 2 + (row+1) * cols * sizeof(LStrHandle));
-                (**results).dimSizes[0] = (row+1); (**results).dimSizes[1] = cols;
+                if ((errnum = mysql_stmt_bind_param(api.my.stmt, &bind[0])) != 0)
+                    {errstr = new string(mysql_error(api.my.con)); StmtClose(api.my.stmt); return -1;}
+                if (mysql_stmt_execute(api.my.stmt) != 0)
+                    {errnum = mysql_errno(api.my.con); errstr = new string(mysql_error(api.my.con));
+                     if (status) for (unsigned int k = 0; k < n; k++) (*status)[j + k] = RowError;
+                     StmtClose(api.my.stmt); return -1;}
+                if (status) for (unsigned int k = 0; k < n; k++) (*status)[j + k] = RowSuccess;
+            }
+            ans = j; if (!select) StmtClose(api.my.stmt);
+            stats.Time(op, tStats::Exec, t0);
+            {errnum = 0; errstr = new string("SUCCESS"); return ans; }
+            break;}
+#endif
 
-                for (int i = 0; i < cols; i++)
+#ifdef ODBCAPI
+        case ODBC:
+        case SqlServer: {
+            if (api.odbc.hDbc == NULL) { errnum = -1; errstr = new string("Connection closed"); return -1; }
+            if (!(api.odbc.hStmt = OdbcPrepare(query))) return -1;
+            stats.Time(op, tStats::Prepare, t0);
+            int rc;
+
+            vector<SQLSMALLINT> CType(cols), SQLType(cols); vector<SQLLEN> size(cols);
+#define CASE(LVt, SQLCt, SQLt, Ct) case LVt:\
+            CType[i] = SQLCt; SQLType[i] = SQLt; size[i] = sizeof(Ct);\
+            break;
+
+            for (i = 0; i < cols; i++)
+            {
+                switch (ColsTD[i]) {    //  NOTE: We may want to use SQL_C_DEFAULT instead of specific C type
+                    CASE(Boolean, SQL_C_BIT, SQL_BIT, u_char)
+                    CASE(U8, SQL_C_UTINYINT, SQL_TINYINT, u_char)
+                    CASE(I8, SQL_C_STINYINT, SQL_TINYINT, char)
+                    CASE(U16, SQL_C_USHORT, SQL_SMALLINT, uInt16)
+                    CASE(I16, SQL_C_SSHORT, SQL_SMALLINT, int16)
+                    CASE(U32, SQL_C_ULONG, SQL_INTEGER, uInt32)
+                    CASE(I32, SQL_C_SLONG, SQL_INTEGER, int32)
+                    CASE(U64, SQL_C_UBIGINT, SQL_BIGINT, uInt64)
+                    CASE(I64, SQL_C_SBIGINT, SQL_BIGINT, int64)
+                    CASE(SGL, SQL_C_FLOAT, SQL_REAL, float)
+                    CASE(DBL, SQL_C_DOUBLE, SQL_DOUBLE, double)
+                    CASE(EXT, SQL_C_CHAR, SQL_VARCHAR, char)    //  decimal text, the server converts it to the column type
+                    CASE(Timestamp, SQL_C_TYPE_TIMESTAMP, SQL_TYPE_TIMESTAMP, SQL_TIMESTAMP_STRUCT)
+                    CASE(String, SQL_C_CHAR, SQL_LONGVARCHAR, char)
+                    CASE(Array, SQL_C_BINARY, SQL_VARBINARY, char)  //  how we pass binary data (not SQL_NTS/null-terminated str)
+                    default:
+                        errstr = new string("Data type (" + to_string(ColsTD[i]) + ") not supported");
+                        StmtClose(api.odbc.hStmt); return -1;
+                }
+            }
+#undef CASE
+
+            //  bind column-wise parameter arrays and send ParamSetSize rows per SQLExecute()
+            int chunk, n; chunk = (ParamSetSize > 0 && ParamSetSize < rows ? ParamSetSize : rows);
+            SQLULEN processed; processed = 0;
+            vector<SQLUSMALLINT> ParamStatus(chunk, SQL_PARAM_UNUSED);
+            rc = SQLSetStmtAttr(api.odbc.hStmt, SQL_ATTR_PARAM_BIND_TYPE, (SQLPOINTER) SQL_PARAM_BIND_BY_COLUMN, 0);
+            if (rc != SQL_ERROR) rc = SQLSetStmtAttr(api.odbc.hStmt, SQL_ATTR_PARAMSET_SIZE, (SQLPOINTER) (SQLULEN) chunk, 0);
+            bool arrays; arrays = (rc != SQL_ERROR);
+            if (arrays)     //  the driver may cap the size with SQL_SUCCESS_WITH_INFO (01S02), send what it took
+               {SQLULEN got = 0; SQLGetStmtAttr(api.odbc.hStmt, SQL_ATTR_PARAMSET_SIZE, &got, 0, NULL);
+                if (got >= 1 && got < (SQLULEN) chunk) chunk = got;
+                SQLSetStmtAttr(api.odbc.hStmt, SQL_ATTR_PARAM_STATUS_PTR, &ParamStatus[0], 0);
+                SQLSetStmtAttr(api.odbc.hStmt, SQL_ATTR_PARAMS_PROCESSED_PTR, &processed, 0);}
+            else chunk = 1;     //  driver without parameter arrays, one row per SQLExecute()
+
+            vector<string> buf(cols); vector<vector<SQLLEN>> ind(cols, vector<SQLLEN>(chunk));
+            const SQLLEN BufMax = 16 << 20;     //  bytes packed per string/BLOB column at most, longer rows go in smaller chunks
+            SQLULEN SetSize; SetSize = chunk; ans = 0;
+            for (j = 0; j < rows; j += n)
+            {
+                n = (rows - j < chunk ? rows - j : chunk);
+                if (n > 1)  //  strings are packed at the stride of the longest, end the chunk before it outgrows BufMax;
+                {           //  a row too long for any company is sent alone, bound in place
+                    vector<SQLLEN> longest(cols, 0); int k;
+                    for (k = 0; k < n; k++)
+                    {
+                        bool fits = true;
+                        for (i = 0; i < cols && fits; i++)
+                            if (ColsTD[i] == String || ColsTD[i] == Array || ColsTD[i] == EXT)
+                                fits = (k == 0 || max(longest[i], (SQLLEN) LStrLen(v[(j + k) * cols + i])) * (k + 1) <= BufMax);
+                        if (!fits) break;
+                        for (i = 0; i < cols; i++) longest[i] = max(longest[i], (SQLLEN) LStrLen(v[(j + k) * cols + i]));
+                    }
+                    n = k;
+                }
+                if (arrays && (SQLULEN) n != SetSize)    //  partial chunk, or back to full size after one
+                    {SQLSetStmtAttr(api.odbc.hStmt, SQL_ATTR_PARAMSET_SIZE, (SQLPOINTER) (SQLULEN) n, 0); SetSize = n;}
+                for (i = 0; i < cols; i++)
                 {
-                    // NOTE:  NULL DB results map only to LStr NULL string -> LStr NULL variant
-                    //        The only LV TD that has a something we can use for NULL is float/double (NaN)
-                    //        In the re-conversion to Numeric/String, NULL Variants should be an error state
+                    SQLLEN len = size[i];   //  element stride in parameter array
+                    bool str = (ColsTD[i] == String || ColsTD[i] == Array || ColsTD[i] == EXT);
+                    SQLPOINTER p;
+                    if (str && n == 1)  //  single row, bind the LV string in place
+                       {len = LStrLen(v[j * cols + i]); ind[i][0] = len;
+                        p = (SQLPOINTER) LStrBuf(v[j * cols + i]); if (!len) len = 1;}
+                    else
+                    {   //  parameter arrays need a fixed stride, pack the column once
+                        if (str) for (int k = 0; k < n; k++) len = max(len, (SQLLEN) LStrLen(v[(j + k) * cols + i]));
+                        buf[i].assign((size_t) len * n, (char) 0);
+                        for (int k = 0; k < n; k++)
+                        {
+                            LStrHandle val = v[(j + k) * cols + i];
+                            memcpy(&buf[i][(size_t) k * len], LStrBuf(val), min((SQLLEN) LStrLen(val), len));
+                            ind[i][k] = (str ? (SQLLEN) LStrLen(val) : size[i]);
+                        }
+                        p = (SQLPOINTER) buf[i].c_str();
+                    }
+                    bool ts = (ColsTD[i] == Timestamp);    //  "YYYY-MM-DD HH:MM:SS.ffffff", microseconds
+                    rc = SQLBindParameter(api.odbc.hStmt, i + 1, SQL_PARAM_INPUT, CType[i], SQLType[i],
+                        (ts ? 26 : len), (ts ? 6 : 0), p, len, &ind[i][0]);
+                    if (rc == SQL_ERROR)
+                        {ODBC_ERROR(SQL_HANDLE_STMT, api.odbc.hStmt, query);
+                         StmtClose(api.odbc.hStmt); return -1;}
+                }
+                rc = SQLExecute(api.odbc.hStmt);
+                bool failed = (rc == SQL_ERROR);
+                for (int k = 0; k < n; k++)
+                {
+                    SQLUSMALLINT st = !arrays ? (failed ? SQL_PARAM_ERROR : SQL_PARAM_SUCCESS) :
+                        ((SQLULEN) k < processed ? ParamStatus[k] : SQL_PARAM_UNUSED);
+                    if (st == SQL_PARAM_SUCCESS || st == SQL_PARAM_SUCCESS_WITH_INFO) ans++;
+                    else if (st != SQL_PARAM_UNUSED) failed = true;
+                    if (status) (*status)[j + k] = st;
+                }
+                if (arrays && !failed && processed < (SQLULEN) n)  //  rows left unprocessed without an error are still lost
+                   {errnum = -1; delete errstr; errstr = new string("Driver processed " + to_string(processed) + " of " + to_string(n) + " rows");
+                    StmtClose(api.odbc.hStmt); return -1;}
+                if (failed)
+                    {ODBC_ERROR(SQL_HANDLE_STMT, api.odbc.hStmt, query);
+                     StmtClose(api.odbc.hStmt); return -1;}
+            }
+            if (!select) StmtClose(api.odbc.hStmt);
+            errnum = 0; stats.Time(op, tStats::Exec, t0);
+            break;}
+#endif
 
-                    if (!is_null[i])
+#ifdef MYCPPAPI
+        case MySQLpp:
+            if (api.mycpp.con == NULL) { errnum = -1; errstr = new string("Connection closed"); return -1; }
+            if (select) { errnum = -1; errstr = new string("Parameterized queries not supported for this RDBMS"); return -1; }
+            try {
+                sql::PreparedStatement* pstmt; pstmt = api.mycpp.con->prepareStatement(query);
+                for (j = 0; j < rows; j++)
+                {
+                    for (i = 0; i < cols; i++)
                     {
-                        switch ((**types).TypeDescriptor[i])
+                        string val = LStrString(v[j * cols + i]);
+                        switch (ColsTD[i])
                         {
                         case I8:
+                            union { char f; char c[sizeof(char)]; } I8_;
+                            I8_.c[0] = val[0]; pstmt->setInt(i + 1, I8_.f);
+                            break;
                         case U8:
-                        CASE(Boolean, char)
+                        case Boolean:
+                            union { u_char f; char c[sizeof(char)]; } U8_;
+                            U8_.c[0] = val[0]; pstmt->setUInt(i + 1, U8_.f);
                             break;
-                        case U16:
-                        CASE(I16, short)
+                        case I32:
+                            union { int f; char c[sizeof(int)]; } I32_;
+                            memcpy(I32_.c, val.c_str(), sizeof(int)); pstmt->setInt(i + 1, I32_.f);
                             break;
                         case U32:
-                        CASE(I32, long)
+                            union { uint f; char c[sizeof(uint)]; } U32_;
+                            memcpy(U32_.c, val.c_str(), sizeof(int)); pstmt->setInt(i + 1, U32_.f);
                             break;
-                        CASE(SGL, float)
+                        case DBL:
+                            union { double f; char c[sizeof(double)]; } DBL_;
+                            memcpy(DBL_.c, val.c_str(), sizeof(double)); pstmt->setDouble(i + 1, DBL_.f);
+                            break;
+                        case String:
+                            pstmt->setString(i + 1, val);
                             break;
-                        CASE(DBL, double)
+                        case Array: //  how we pass BLOB data (not null-terminated str)
+                            std::stringstream *stream; stream->write(& val[0], val.length());
+                            pstmt->setBlob(i + 1, stream);
                             break;
-                        case  String:
-                        case  Array:
                         default:
-                            if (length[i] > str[i].length())
-                                {errnum = -1; errstr = new string("Field data truncated, col: " + to_string(i + 1)
-                                                     + "Use BLOB feature or increase StrLenBuf to " + to_string(length[i])); return -1;}
-                            else
-                                (**results).elt[row * cols + i] = LVStr(str[i], length[i]);
                             break;
                         }
-                        length[i] = 0;  //  I suspect NULLs fields don't update this value to zero before the next fetch
                     }
+                    pstmt->executeUpdate();
                 }
-                row++; 
+                delete pstmt; return j;
             }
-            if (rc == 1) MYSQL_EXIT();
-
-            delete api.my.bind;
-            mysql_free_result(api.my.query_results);
-            if (mysql_stmt_close(api.my.stmt))
-                {errnum = mysql_errno(api.my.con); errstr = new string(mysql_error(api.my.con)); return -1;}
-            errnum = 0;
-            break;}
-#undef CASE
+            catch (sql::SQLException& e) {
+                errstr = new string(e.what()); errdata = new string(query);
+                errnum = e.getErrorCode();  return -1;
+            }          break;
 #endif
 
-#ifdef ODBCAPI
-#if 1   //  CASE() MACRO
-#define CASE(xTD, cType, sType)   case  xTD:\
-    res[i] = (cType) 0; DataLen[i] = sizeof(cType);\
-    if (StrBufLen) rc = SQLBindCol(api.odbc.hStmt, i + 1, sType, &(res[i]),\
-        sizeof(cType), &(DataLen[i]));\
-    else rc = 0;\
-    if (rc == SQL_ERROR)\
-    {\
-        ODBC_ERROR(SQL_HANDLE_STMT, api.odbc.hStmt, "Column " + to_string(i + 1) + "; type " + to_string(t));\
-        SQLFreeHandle(SQL_HANDLE_STMT, api.odbc.hStmt); return -1;\
+        default:
+            errstr = new string("Unsupported RDBMS"); return -1;
+            break;
+        }
+        return ans;
     }
-#endif
-        case ODBC:
-        case SqlServer:
-            for (SQLUSMALLINT i = 0; i < cols; i++)
-            {
-                int t = (**types).TypeDescriptor[i];
-                switch (t)
-                {  //  any of these numeric type might overflow, that's what we'd like to catch
-                CASE(Boolean, char, SQL_C_BIT)
-                    break;
-                case  I8:
-                CASE(U8, char, SQL_C_CHAR)
-                    break;
-                CASE(U32, unsigned long, SQL_C_ULONG)
-                    break;
-                CASE(I32, long, SQL_C_LONG)
-                    break;
-                CASE(SGL, float, SQL_C_FLOAT)
-                    break;
-                CASE(DBL, double, SQL_C_DOUBLE)
-                    break;
-                case String:    //  Looking at documentation, it appears SQL_C_BINARY and SQL_C_CHAR are interchangeable
-                case Array:     //  Though SQL_C_CHAR means terminating wchar NULL; SQL_C_BINARY, no terminator
-                    if (StrBufLen) //  StrBufLen == 0 means don't bind, and use SQLGetData() after SQLFetch()
-                    {
-                        DataLen[i] = StrBufLen;
-                        rc = SQLBindCol(api.odbc.hStmt, i + 1, (t == String ? SQL_C_CHAR: SQL_C_BINARY),
-                                    (char*) str[i].c_str(), DataLen[i], &(DataLen[i]));
-                        if (rc == SQL_ERROR)
-                        {
-                            ODBC_ERROR(SQL_HANDLE_STMT, api.odbc.hStmt, "Column " + to_string(i + 1) + "; type " + to_string(t));
-                            SQLFreeHandle(SQL_HANDLE_STMT, api.odbc.hStmt); return false;
-                        }
-                    }
-                    else 
-                       {DataLen[i] = 0;
-                        rc = SQLBindCol(api.odbc.hStmt, i + 1, (t == String ? SQL_C_CHAR: SQL_C_BINARY),
-                                    0, DataLen[i], &(DataLen[i]));
-                        if (rc == SQL_ERROR)
-                        {
-                            ODBC_ERROR(SQL_HANDLE_STMT, api.odbc.hStmt, "Column " + to_string(i + 1) + "; type " + to_string(t));
-                            SQLFreeHandle(SQL_HANDLE_STMT, api.odbc.hStmt); return false;
-                        }}
-                    break;
-                default:
-                    errnum = -1; errstr = new string("Unsupported data type: " + to_string(t));
-                    return errnum;
-                    break;
-                }
 
+    int QueryPrepared(string query, LStrHandle v[], int rows, int cols, uint16_t ColsTD[], TypesHdl types, ResultSetHdl results) {  //  run query
+        //  once per row of parameters "v", bound as UpdatePrepared() binds them, and return the result rows of all runs in order
+        int n = 0, ResCols = (**types).dimSize;
+        if (rows * cols == 0) { errnum = -1; errdata = new string(query); errstr = new string("No parameters, use Query"); return -1; }
+        if (Busy(query)) return -1;
+        (**results).dimSizes[0] = 0; (**results).dimSizes[1] = ResCols;
+        ResultSetHdl part = (rows == 1 ? results : (ResultSetHdl) DSNewHClr(offsetof(ResultSet, elt)));  //  result of one run,
+        if (!part) { errnum = -1; errstr = new string("Out of memory"); return -1; }    //  appended to results
+        for (int j = 0; j < rows; j++)
+        {
+            int r = 0;
+            if (UpdateRows(query, v + (size_t) j * cols, 1, cols, ColsTD, NULL, true) < 0) break;
+            if (GetResults(&r, ResCols, types, part) < 0)
+            {
+                if (part != results)    //  cells of the failed run
+                    for (long k = 0; k < (**part).dimSizes[0] * ResCols; k++) if ((**part).elt[k]) DSDisposeHandle((**part).elt[k]);
+                break;
             }
-#undef CASE
-
-#if 1   //  CASE() MACRO
-#define CASE(xTD, cType, sType) \
-     case  xTD:\
-            if (StrBufLen == 0){\
-                DataLen[i] = sizeof(cType);\
-                rc = SQLGetData(api.odbc.hStmt, i + 1, sType, &(res[i]), DataLen[i], & DataLen[i]);\
-                if (rc == SQL_ERROR)\
-                {\
-                    ODBC_ERROR(SQL_HANDLE_STMT, api.odbc.hStmt, "Column " + to_string(i + 1) + "; type " + to_string(t));\
-                    SQLFreeHandle(SQL_HANDLE_STMT, api.odbc.hStmt); return -1;\
-                }}\
-            (**results).elt[row * cols + i] = LVStr((char*) &(res[i]), sizeof(cType));
-#endif
-
-            row = 0; rc = SQLFetch(api.odbc.hStmt);
-            if (rc == SQL_ERROR)
+            if (part == results) { n = r; break; }
+            if (DSSetHandleSize(results, offsetof(ResultSet, elt) + (size_t) (n + r) * ResCols * sizeof(LStrHandle)) != mgNoErr)
             {
-                ODBC_ERROR(SQL_HANDLE_STMT, api.odbc.hStmt, "");
-                SQLFreeHandle(SQL_HANDLE_STMT, api.odbc.hStmt); return false;
+                for (long k = 0; k < (long) r * ResCols; k++) if ((**part).elt[k]) DSDisposeHandle((**part).elt[k]);
+                errnum = -1; errstr = new string("Out of memory"); break;
             }
-            while (rc  != SQL_NO_DATA)
+            if (r) memcpy(&(**results).elt[(size_t) n * ResCols], (**part).elt, (size_t) r * ResCols * sizeof(LStrHandle));
+            (**results).dimSizes[0] = (n += r);
+        }
+        if (part != results) DSDisposeHandle(part);
+        return errnum ? -1 : n;
+    }
+
+#ifdef MYAPI
+    struct tInfile {    //  LOAD DATA LOCAL INFILE source, the DataSet encoded a row at a time as the server asks for it
+        LStrHandle* v; int rows, cols; uint16_t* ColsTD;
+        int row = 0;            //  next row to encode
+        string line; size_t off = 0;    //  encoded row, bytes of it already sent
+        uint64_t bytes = 0;
+    };
+
+    static void InfileRow(tInfile* f) {  //  encode next row, tab-separated with backslash escapes, numbers in full precision
+        string& s = f->line; s.clear(); f->off = 0; char num[32];
+#define CASE(xTD, cType, fmt) case  xTD:\
+            {cType x = 0; memcpy(&x, LStrBuf(val), min((int) LStrLen(val), (int) sizeof(cType)));\
+             s.append(num, snprintf(num, sizeof(num), fmt, x));}\
+            break;
+
+        for (int i = 0; i < f->cols; i++)
+        {
+            LStrHandle val = f->v[f->row * f->cols + i];
+            if (i) s += '\t';
+            switch (f->ColsTD[i])
             {
-                if (rc == SQL_ERROR)
-                {
-                    ODBC_ERROR(SQL_HANDLE_STMT, api.odbc.hStmt, "");
-                    SQLFreeHandle(SQL_HANDLE_STMT, api.odbc.hStmt); return -1;
-                }
-                //  allocate another row
-                DSSetHandleSize(results, sizeof(int32) * 2 + (row + 1) * cols * sizeof(LStrHandle));
-                (**results).dimSizes[0] = (row + 1); (**results).dimSizes[1] = cols;
-                for (SQLUSMALLINT i = 0; i < cols; i++)
-                {
-                    int t = (**types).TypeDescriptor[i];
-                    switch (t)
+            CASE(Boolean, uInt8, "%u")
+            CASE(U8, uInt8, "%u")
+            CASE(I8, int8, "%d")
+            CASE(U16, uInt16, "%u")
+            CASE(I16, int16, "%d")
+            CASE(U32, uInt32, "%u")
+            CASE(I32, int32, "%d")
+            CASE(U64, unsigned long long, "%llu")
+            CASE(I64, long long, "%lld")
+            CASE(SGL, float, "%.9g")    //  enough digits to round-trip
+            CASE(DBL, double, "%.17g")
+            default:    //  String, Array (BLOB); bytes as they are, only the delimiters escaped
+                for (char* p = LStrBuf(val), *e = p + LStrLen(val); p < e; p++)
+                    switch (*p)
                     {
-                    CASE(Boolean, char, SQL_C_BIT)
-                        break;
-                    case  I8:
-                    CASE(U8, char, SQL_C_CHAR)
-                        break;
-                    case I32:
-                    CASE(U32, u_int32_t, SQL_C_ULONG)
-                        break;
-                    CASE(SGL, float, SQL_C_FLOAT)
-                        break;
-                    CASE(DBL, double, SQL_C_DOUBLE)
-                        break;
-                    case String:
-                    case Array:
-                        if (StrBufLen)
-                           {(**results).elt[row * cols + i] = LVStr((char*) str[i].c_str(), DataLen[i]);
-                            if (DataLen[i] > StrBufLen)
-                                {errnum = -1; errstr = new string("Truncated data, column:" + to_string(i + 1)); return -1;}}
-                        else
-                        {
-                            bool Init = true; SQLINTEGER RtnDataLen = StrBlobLen;
-                            DataLen[i] = RtnDataLen; string str = string(RtnDataLen, (char) 0);
-                            while ((rc = SQLGetData(api.odbc.hStmt, i + 1, (t == Array ? SQL_C_BINARY: SQL_C_CHAR), (char*) str.c_str(),
-                                DataLen[i], (SQLLEN*) &RtnDataLen)) != SQL_NO_DATA)  //  DataLen[i] will be equal to SqlBlobLen until the last call
-                            {  
-                                if (rc == SQL_ERROR) break;
-                                if (DataLen[i] == SQL_NULL_DATA) break; //  it appears field == NULL, leave results string NULL
-                                int NumBytes = (RtnDataLen > DataLen[i]) || (RtnDataLen == SQL_NO_TOTAL) ?
-                                    DataLen[i] - (t == Array ? 0 : 2) : RtnDataLen; //  "2" may correspond to wchar termination
-                                if (Init) {(**results).elt[row * cols + i] = LVStr(str, NumBytes); Init = false;}
-                                else LV_str_cat((**results).elt[row * cols + i], str, NumBytes);
-                            }
-                            if (rc == SQL_ERROR)
-                            {
-                                ODBC_ERROR(SQL_HANDLE_STMT, api.odbc.hStmt, "");
-                                SQLFreeHandle(SQL_HANDLE_STMT, api.odbc.hStmt);
-                                return errnum;
-                            }
-                        }
-                        break;
-                    default:
-                        break;
+                    case '\\': s += "\\\\"; break;
+                    case '\t': s += "\\t"; break;
+                    case '\n': s += "\\n"; break;
+                    case '\0': s += "\\0"; break;
+                    default: s += *p; break;
                     }
-                }
-                rc = SQLFetch(api.odbc.hStmt); row++;
+                break;
             }
-#undef CASE            
-            break;
+        }
+#undef CASE
+        s += '\n'; f->row++; f->bytes += s.length();
+    }
+
+    static int InfileInit(void** ptr, const char* name, void* data) { *ptr = data; return data ? 0 : 1; }  //  LOCAL request outside BulkLoad()
+    static void InfileEnd(void* ptr) {}
+    static int InfileError(void* ptr, char* msg, unsigned int len) { snprintf(msg, len, "sql_LV++ bulk load source failed"); return 2000; }
+    static int InfileRead(void* ptr, char* buf, unsigned int len) {  //  fill buf from encoded rows, 0 at end of DataSet
+        tInfile* f = (tInfile*) ptr; unsigned int n = 0;
+        while (n < len)
+        {
+            if (f->off == f->line.length()) { if (f->row == f->rows) break; InfileRow(f); }
+            size_t k = min((size_t) (len - n), f->line.length() - f->off);
+            memcpy(buf + n, f->line.c_str() + f->off, k); f->off += k; n += k;
+        }
+        return n;
+    }
+#endif
+
+    int BulkLoad(string table, string columns, LStrHandle v[], int rows, int cols, uint16_t ColsTD[], int32* warnings) {  //  load DataSet into table,
+        //  MySQL streams it from memory through LOAD DATA LOCAL INFILE, others INSERT with UpdatePrepared(); return rows loaded
+        errnum = -1; *warnings = 0; ResultInvalidate("INTO " + table);
+        if (table.length() < 1) { errdata = new string(table); errstr = new string("Table name may not be blank"); return -1; }
+        if (Busy(table)) return -1;
+        if (rows * cols == 0) { errdata = new string(table); errstr = new string("No data to post"); return -1; }
+        for (int i = 0; i < cols; i++)
+            if (!TDSize(ColsTD[i])) { errdata = new string(table); errstr = new string("Data type (" + to_string(ColsTD[i]) + ") not supported"); return -1; }
+        if (columns.length()) columns = " (" + columns + ")";
+
+        switch (type)
+        {
+#ifdef MYAPI
+        case MySQL: {
+            if (api.my.con == NULL) { errdata = new string(table); errstr = new string("Connection closed"); return -1; }
+            //  binary character set so strings and BLOBs are loaded byte for byte, the file name is only handed to InfileInit()
+            string query = "LOAD DATA LOCAL INFILE 'sql_LVpp' INTO TABLE " + table + " CHARACTER SET binary"
+                " FIELDS TERMINATED BY '\\t' ESCAPED BY '\\\\' LINES TERMINATED BY '\\n'" + columns;
+            errdata = new string(query);
+            auto t0 = chrono::steady_clock::now();
+            tInfile f; f.v = v; f.rows = rows; f.cols = cols; f.ColsTD = ColsTD;
+            mysql_set_local_infile_handler(api.my.con, InfileInit, InfileRead, InfileEnd, InfileError, &f);
+            int rc = mysql_real_query(api.my.con, query.c_str(), query.length());
+            mysql_set_local_infile_handler(api.my.con, InfileInit, InfileRead, InfileEnd, InfileError, NULL);  //  "f" goes out of scope
+            stats.Count(tStats::Update, tStats::BytesOut, query.length() + f.bytes);
+            if (rc) MYSQL_EXIT();
+            stats.Time(tStats::Update, tStats::Exec, t0);
+            *warnings = mysql_warning_count(api.my.con);
+            errnum = 0; return mysql_affected_rows(api.my.con);
+            break;}
+#endif
+
+#ifdef ODBCAPI
+        case ODBC:
+        case SqlServer: {
+            string marks = "?"; for (int i = 1; i < cols; i++) marks += ", ?";
+            return UpdatePrepared("INSERT INTO " + table + columns + " VALUES (" + marks + ")", v, rows, cols, ColsTD);
+            break;}
+#endif
+
+        default:
+            errdata = new string(table); errstr = new string("Bulk load not supported for this RDBMS");
+            break;
+        }
+        return -1;
+    }
+
+    int GetResults(int *rows, int cols, TypesHdl types, ResultSetHdl results, bool stored = false) {  //  return results as LV flattened strings
+        errnum = 0; int rc;
+        int row = 0; //  row number
+        vector<string> str(cols);   //  bound string/BLOB buffers, sized from result metadata
+        vector<array<double, 8>> num(cols); //  bound numeric buffers, 64 bytes holds any numeric type and date-time struct
+        vector<tConv> conv(cols);   //  converter per column, resolved once per query
+        auto t0 = chrono::steady_clock::now(); chrono::steady_clock::duration fetch{0};
+#ifdef ODBCAPI
+        auto Fetch = [&] {auto tf = chrono::steady_clock::now(); SQLRETURN r = SQLFetch(api.odbc.hStmt);
+                          fetch += chrono::steady_clock::now() - tf; return r;};
+#endif
+        size_t capacity = 0;    //  rows allocated in results, sized once if the count is known, else grown geometrically
+        auto Reserve = [&](size_t n) {
+            if (n <= capacity) return true;
+            size_t c = max(n, capacity * 2);
+            if (DSSetHandleSize(results, offsetof(ResultSet, elt) + c * cols * sizeof(LStrHandle)) != mgNoErr)
+                {errnum = -1; errstr = new string("Out of memory"); return false;}
+            memset(&(**results).elt[capacity * cols], 0, (c - capacity) * cols * sizeof(LStrHandle));  //  NULL fields stay NULL strings
+            capacity = c; (**results).dimSizes[1] = cols;
+            return true;
+        };
+        (**results).dimSizes[0] = 0;
+        if (*rows > 0 && !Reserve(*rows)) return -1;   //  we know the number of rows before hand
+
+        switch (type)
+        {
+        case NULL:
+            break;
+
+#ifdef MYAPI
+        case MySQL: {
+            if (!(api.my.query_results = mysql_stmt_result_metadata(api.my.stmt))) //  Fetch result set meta information
+                MYSQL_EXIT();
+            if (cols != mysql_num_fields(api.my.query_results))
+                {errnum = -1; errstr = new string("Data column number mismatch");
+                 mysql_free_result(api.my.query_results); StmtClose(api.my.stmt); return -1;}
+
+            /* Fetch result set meta information */
+            MYSQL_FIELD* fields; fields = mysql_fetch_fields(api.my.query_results);
+
+            vector<unsigned long> length(cols, 0);
+            vector<my_bool> error(cols, 0), is_null(cols, 0);
+            vector<MYSQL_BIND> bind(cols); memset(&bind[0], 0, cols * sizeof(MYSQL_BIND));
+
+            for (int i = 0; i < cols; i++) {  //  bind buffers in the server's type, the converter makes the LV type
+                MYSQL_BIND& b = bind[i];
+                b.is_null = &is_null[i]; b.error = &error[i]; b.length = &length[i];
+                b.buffer_type = fields[i].type; b.is_unsigned = (fields[i].flags & UNSIGNED_FLAG) != 0;
+                b.buffer = (IsText(fields[i].type) ? NULL : &num[i]);  //  strings are sized once max_length is known
+                if (!(conv[i] = MyConv(&fields[i], (**types).TypeDescriptor[i])))
+                {
+                    errnum = -1; errstr = new string("Unsupported MySQL type: " + to_string(fields[i].type) + " as data type "
+                        + to_string((**types).TypeDescriptor[i]) + ", column " + to_string(i + 1));
+                    mysql_free_result(api.my.query_results); StmtClose(api.my.stmt);
+                    return -1;
+                }
+            }
+            int k = 1;
+            if (!stored)    //  asynchronous queries store results on the event loop
+               {if (mysql_stmt_attr_set(api.my.stmt, STMT_ATTR_UPDATE_MAX_LENGTH, &k)) MYSQL_EXIT();
+                if (mysql_stmt_store_result(api.my.stmt)) MYSQL_EXIT();
+                stats.Time(tStats::Query, tStats::Fetch, t0);}
+            if (!Reserve(mysql_stmt_num_rows(api.my.stmt)))
+                {mysql_free_result(api.my.query_results); StmtClose(api.my.stmt); return -1;}
+
+            for (int i = 0; i < cols; i++) {  //  longest value in result set, longer than StrBufLen are read by MyFetchColumn()
+                if (!IsText(fields[i].type)) continue;
+                str[i] = string(MyBufLen(&fields[i]), (char) 0);
+                bind[i].buffer = (char*) str[i].c_str();
+                bind[i].buffer_length = str[i].length();
+            }
+            if (mysql_stmt_bind_result(api.my.stmt, &bind[0])) MYSQL_EXIT();
+            while ((rc = mysql_stmt_fetch(api.my.stmt)) != 1 && rc != MYSQL_NO_DATA) {  //  Fetch all rows
+                if (!Reserve(row + 1)) {mysql_free_result(api.my.query_results); StmtClose(api.my.stmt); return -1;}
+                LStrHandle* cell = &(**results).elt[(size_t) row * cols];
+                for (int i = 0; i < cols; i++)
+                {
+                    // NOTE:  NULL DB results map only to LStr NULL string -> LStr NULL variant
+                    //        The only LV TD that has a something we can use for NULL is float/double (NaN)
+                    //        In the re-conversion to Numeric/String, NULL Variants should be an error state
+                    if (is_null[i]) continue;
+                    if (bind[i].buffer != &num[i] && length[i] > str[i].length())
+                       {if (!(cell[i] = MyFetchColumn(api.my.stmt, &bind[i], i, length[i])))
+                            {mysql_free_result(api.my.query_results); StmtClose(api.my.stmt); return -1;}}
+                    else
+                        cell[i] = conv[i](bind[i].buffer, length[i]);
+                }
+                (**results).dimSizes[0] = ++row;
+            }
+            if (rc == 1) MYSQL_EXIT();
+
+            mysql_free_result(api.my.query_results);
+            if (StmtClose(api.my.stmt))
+                {errnum = mysql_errno(api.my.con); errstr = new string(mysql_error(api.my.con)); return -1;}
+            errnum = 0;
+            break;}
+#endif
+
+#ifdef ODBCAPI
+        case ODBC:
+        case SqlServer: {
+            int FirstUnbound; FirstUnbound = cols;  //  string/BLOB buffers from column octet length, ODBC reads the
+            vector<SQLLEN> size(cols);              //  first column too long for StrBufLen, and all after it, with SQLGetData()
+            for (SQLUSMALLINT i = 0; i < cols; i++)
+            {
+                int t = (**types).TypeDescriptor[i];
+                if (t != String && t != Array) continue;
+                if (!(size[i] = OdbcBufLen(api.odbc.hStmt, i + 1, t))) {FirstUnbound = i; break;}
+            }
+            //  block cursor: one SQLFetch() fills RowArraySize rows of column-wise arrays; SQLGetData() needs one row at a time
+            SQLULEN block = (FirstUnbound == cols && RowArraySize > 1 ? RowArraySize : 1), fetched = 1;
+            if (block > 1 && SQLSetStmtAttr(api.odbc.hStmt, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER) block, 0) == SQL_ERROR)
+                block = 1;  //  driver without block cursors
+            vector<SQLUSMALLINT> RowStatus(block, SQL_ROW_SUCCESS);
+            if (block > 1)
+               {SQLSetStmtAttr(api.odbc.hStmt, SQL_ATTR_ROWS_FETCHED_PTR, &fetched, 0);
+                SQLSetStmtAttr(api.odbc.hStmt, SQL_ATTR_ROW_STATUS_PTR, &RowStatus[0], 0);}
+            vector<SQLSMALLINT> CType(cols); vector<string> buf(cols); vector<vector<SQLLEN>> DataLen(cols, vector<SQLLEN>(block, 0));
+            for (SQLUSMALLINT i = 0; i < cols; i++)
+            {   //  driver converts to the LV type, the converter only copies it out
+                int t = (**types).TypeDescriptor[i];
+                if (!(CType[i] = OdbcCType(t)) || !(conv[i] = OdbcConv(t)))
+                    {errnum = -1; errstr = new string("Unsupported data type: " + to_string(t)); StmtClose(api.odbc.hStmt); return -1;}
+                if (t == EXT) size[i] = 80;     //  decimal text, DECIMAL(65,30) and sign fit
+                else if (t == Timestamp) size[i] = sizeof(SQL_TIMESTAMP_STRUCT);
+                else if (t != String && t != Array) size[i] = TDSize(t);
+                buf[i].assign((size_t) size[i] * block, (char) 0);
+                if (i < FirstUnbound && SQLBindCol(api.odbc.hStmt, i + 1, CType[i], &buf[i][0],
+                        size[i], &DataLen[i][0]) == SQL_ERROR)  //  others are read with SQLGetData() after SQLFetch()
+                {
+                    ODBC_ERROR(SQL_HANDLE_STMT, api.odbc.hStmt, "Column " + to_string(i + 1) + "; type " + to_string(t));
+                    StmtClose(api.odbc.hStmt); return -1;
+                }
+            }
+
+            while ((rc = Fetch()) != SQL_NO_DATA)
+            {
+                if (rc == SQL_ERROR)
+                {
+                    ODBC_ERROR(SQL_HANDLE_STMT, api.odbc.hStmt, "");
+                    StmtClose(api.odbc.hStmt); return -1;
+                }
+                if (!Reserve(row + fetched)) {StmtClose(api.odbc.hStmt); return -1;}
+                for (SQLULEN b = 0; b < fetched; b++)
+                {
+                    if (RowStatus[b] == SQL_ROW_ERROR)
+                        {ODBC_ERROR(SQL_HANDLE_STMT, api.odbc.hStmt, "Row " + to_string(row + 1)); StmtClose(api.odbc.hStmt); return -1;}
+                    LStrHandle* cell = &(**results).elt[(size_t) row * cols];
+                    for (SQLUSMALLINT i = 0; i < cols; i++)
+                    {
+                        int t = (**types).TypeDescriptor[i]; bool s = (t == String || t == Array);
+                        char* p = &buf[i][(size_t) b * size[i]]; SQLLEN& len = DataLen[i][b];
+                        if (i >= FirstUnbound)
+                        {
+                            if (s)  //  in StrBlobLen chunks
+                            {
+                                string val; bool null;
+                                if (OdbcGetData(api.odbc.hStmt, i + 1, t, val, null) == SQL_ERROR)
+                                    {ODBC_ERROR(SQL_HANDLE_STMT, api.odbc.hStmt, ""); StmtClose(api.odbc.hStmt); return -1;}
+                                if (!null) cell[i] = LVStr(val);
+                                continue;
+                            }
+                            if (SQLGetData(api.odbc.hStmt, i + 1, CType[i], p, size[i], &len) == SQL_ERROR)
+                            {
+                                ODBC_ERROR(SQL_HANDLE_STMT, api.odbc.hStmt, "Column " + to_string(i + 1) + "; type " + to_string(t));
+                                StmtClose(api.odbc.hStmt); return -1;
+                            }
+                        }
+                        if (len == SQL_NULL_DATA) continue;  //  leave results string NULL
+                        s = (s || t == EXT);    //  EXT is read as text
+                        if (s && (len == SQL_NO_TOTAL || len > size[i] - (t != Array ? 1 : 0)))
+                            {errnum = -1; errstr = new string("Driver reported short column length, column:" + to_string(i + 1) + ", use SetBufLen(0)");
+                             StmtClose(api.odbc.hStmt); return -1;}
+                        cell[i] = conv[i](p, len);
+                    }
+                    (**results).dimSizes[0] = ++row;
+                }
+            }
+            StmtClose(api.odbc.hStmt);
+            break;}
+#endif
+
+#ifdef MYCPPAPI
+#define CASE(xTD, cType, method) \
+     case  xTD:\
+            union { cType d; char str[sizeof(cType)]; } xTD ## _;\
+            xTD ## _.d = res->method(i + 1);\
+            (**results).elt[row * cols + i] = (LStrHandle) DSNewHandle(sizeof(int32) + sizeof(cType));\
+            LV_strncpy((**results).elt[row * cols + i], xTD ## _.str, sizeof(cType));
+                            
+        case MySQLpp:
+            try {
+                sql::ResultSet* res = api.mycpp.res; //  sql::ResultSet
+                while (res->next())
+                {
+                    if (!Reserve(row + 1)) break;
+                    for (int i = 0; i < cols; i++) {
+                        if (!res->isNull(i + 1))
+                            switch ((**types).TypeDescriptor[i])
+                            {
+                            case  Boolean:  //  any of these numeric type might overflow, that's what we'd like to catch
+                            CASE(U8, u_char, getInt)
+                                break;
+                            CASE(I8, char, getInt)
+                                break;
+                            CASE(U16, u_int16_t, getInt)
+                                break;
+                            CASE(I16, int16_t, getInt)
+                                break;
+                            CASE(U32, u_int32_t, getInt)
+                                break;
+                            CASE(I32, int32, getInt)
+                                break;
+                            CASE(SGL, float, getDouble)
+                                break;
+                            CASE(DBL, double, getDouble)
+                                break;
+                            case  String:
+                            default:
+                                (**results).elt[row * cols + i] = (LStrHandle)DSNewHandle(0);
+                                LV_str_cp((**results).elt[row * cols + i], res->getString(i + 1));  //  <- std::string, handles binaries
+                                break;
+                            }
+                    }
+                    row++;
+                }
+                errnum = 0; delete errdata;
+            }
+            catch (sql::SQLException& e) {
+                errstr = new string(e.what());
+                errnum = e.getErrorCode();
+            }
+
+            delete api.mycpp.res; delete api.mycpp.stmt;
+            break;
+#undef CASE
+#endif
+
+        default:
+            errnum = -1; errstr = new string("Unsupported RDBMS"); return -1;
+            break;
+        }
+        if (capacity != (size_t) row)   //  trim to the rows fetched
+            DSSetHandleSize(results, offsetof(ResultSet, elt) + (size_t) row * cols * sizeof(LStrHandle));
+        (**results).dimSizes[0] = row; (**results).dimSizes[1] = cols;
+        stats.Split(tStats::Query, t0, fetch);
+        return errnum ? -1 : (*rows = row);
+    }
+
+    static int TDSize(int t) {  //  LV element size of a column type, 0 if not supported as a column
+        switch (t)
+        {
+        case Boolean: case I8: case U8:
+            return 1;
+        case I16: case U16:
+            return 2;
+        case I32: case U32: case SGL:
+            return 4;
+        case I64: case U64: case DBL:
+            return 8;
+        case String: case Array:
+            return sizeof(LStrHandle);
+        default:
+            return 0;
+        }
+    }
+
+    //  LV timestamp: I64 seconds since 1904-01-01 00:00 UTC and U64 fraction of 2^-64 s, native byte order;
+    //  DB dates and times carry no zone and are taken as UTC
+    struct LvTime { uInt64 frac; int64 sec; };
+    struct tCivil { int year; unsigned month, day, hour, minute, second; uint32_t ns; };
+    static LvTime ToLvTime(int y, unsigned mo, unsigned d, int64 s, uint32_t ns) {  //  date plus "s" seconds and "ns"
+        int64 yy = y - (mo <= 2), era = (yy >= 0 ? yy : yy - 399) / 400; unsigned yoe = (unsigned) (yy - era * 400);
+        unsigned doy = (153 * (mo > 2 ? mo - 3 : mo + 9) + 2) / 5 + d - 1, doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+        LvTime t; t.sec = (era * 146097 + doe - 719468) * 86400 + 2082844800 + s;  //  days since 1970, 1904 to 1970
+        t.frac = (uInt64) (ns * 18446744073.709551616); return t;
+    }
+    static tCivil FromLvTime(LvTime t, uint32_t unit) {  //  date and time of "t", fraction rounded to "unit" ns
+        tCivil c; int64 s = t.sec - 2082844800;
+        uint64_t ns = (uint64_t) llround(t.frac / 18446744073.709551616 / unit) * unit;
+        if (ns >= 1000000000) {ns -= 1000000000; s++;}
+        int64 z = (s >= 0 ? s : s - 86399) / 86400, sod = s - z * 86400;
+        c.ns = (uint32_t) ns; c.hour = (unsigned) (sod / 3600); c.minute = (unsigned) (sod / 60 % 60); c.second = (unsigned) (sod % 60);
+        z += 719468; int64 era = (z >= 0 ? z : z - 146096) / 146097; unsigned doe = (unsigned) (z - era * 146097);
+        unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365, doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+        unsigned mp = (5 * doy + 2) / 153;
+        c.day = doy - (153 * mp + 2) / 5 + 1; c.month = (mp < 10 ? mp + 3 : mp - 9); c.year = (int) (yoe + era * 400 + (c.month <= 2));
+        return c;
+    }
+
+    //  EXT: IEEE 754 binary128, native byte order like LvTime; through long double, exact for 80 bit long double
+    struct LvQuad { uInt64 lo, hi; };
+    static LvQuad ToQuad(long double x) {
+        LvQuad q = {0, signbit(x) ? 1ULL << 63 : 0};
+        if (isnan(x)) q.hi |= 0x7FFF800000000000ULL;
+        else if (isinf(x)) q.hi |= 0x7FFF000000000000ULL;
+        else if (x != 0)
+        {   //  m in [0.5, 1): 1.f * 2^(e - 1), below 2^-16382 subnormal 0.f * 2^-16382
+            int e; long double m = frexpl(fabsl(x), &e), f; uInt64 be = 0;
+            if (e + 16382 > 0) {f = 2 * m - 1; be = e + 16382;} else f = ldexpl(m, e + 16382);
+            f = ldexpl(f, 48); uInt64 h = (uInt64) f;
+            q.hi |= be << 48 | h; q.lo = (uInt64) ldexpl(f - h, 64);
+        }
+        return q;
+    }
+    static long double FromQuad(LvQuad q) {
+        int be = (int) (q.hi >> 48 & 0x7FFF);
+        long double f = ldexpl((long double) (q.hi & 0xFFFFFFFFFFFFULL), -48) + ldexpl((long double) q.lo, -112), x;
+        if (be == 0x7FFF) x = (f != 0 ? NAN : INFINITY);
+        else x = (be ? ldexpl(1 + f, be - 16383) : ldexpl(f, -16382));
+        return (q.hi >> 63 ? -x : x);
+    }
+    static string ExtText(LStrHandle v) {  //  EXT cell as decimal text, every digit long double holds
+        LvQuad q = {0, 0}; memcpy(&q, LStrBuf(v), min((size_t) LStrLen(v), sizeof(q)));
+        char s[64]; int n = snprintf(s, sizeof(s), "%.*Lg", numeric_limits<long double>::max_digits10, FromQuad(q));
+        return string(s, n);
+    }
+
+    //  result converters, one per (bound C type, LV type) pair, picked once per query and called per cell
+    typedef LStrHandle (*tConv)(const void* p, unsigned long len);   //  bound value to new LV flattened string
+    static LStrHandle StrConv(const void* p, unsigned long len) { return LVStr((char*) p, len); }
+    template <int N> static LStrHandle RawConv(const void* p, unsigned long len) { return LVStr((char*) p, N); }
+    template <class From, class To> static LStrHandle NumConv(const void* p, unsigned long len) {
+        To x = (To) *(const From*) p; return LVStr((char*) &x, sizeof(To));
+    }
+    template <class From> static LStrHandle TextConv(const void* p, unsigned long len) {  //  number as text, full precision
+        char s[32]; From x = *(const From*) p;
+        int n = (is_floating_point<From>::value ? snprintf(s, sizeof(s), sizeof(From) == 4 ? "%.9g" : "%.17g", (double) x) :
+                 is_unsigned<From>::value ? snprintf(s, sizeof(s), "%llu", (unsigned long long) x) :
+                 snprintf(s, sizeof(s), "%lld", (long long) x));
+        return LVStr(s, n);
+    }
+    template <class To> static LStrHandle ParseConv(const void* p, unsigned long len) {  //  text to number
+        string s((const char*) p, len); To x;   //  64 bit integers parsed as such, double would round them
+        if (is_floating_point<To>::value || sizeof(To) < 8) x = (To) strtod(s.c_str(), NULL);
+        else if (is_unsigned<To>::value) x = (To) strtoull(s.c_str(), NULL, 10);
+        else x = (To) strtoll(s.c_str(), NULL, 10);
+        return LVStr((char*) &x, sizeof(To));
+    }
+    template <class From> static LStrHandle ExtConv(const void* p, unsigned long len) {  //  number to EXT
+        LvQuad q = ToQuad((long double) *(const From*) p); return LVStr((char*) &q, sizeof(q));
+    }
+    static LStrHandle ParseExt(const void* p, unsigned long len) {  //  text, e.g. DECIMAL, to EXT
+        LvQuad q = ToQuad(strtold(string((const char*) p, len).c_str(), NULL)); return LVStr((char*) &q, sizeof(q));
+    }
+    static LStrHandle ParseTime(const void* p, unsigned long len) {  //  "YYYY-MM-DD[ HH:MM:SS[.fraction]]" to timestamp
+        string s((const char*) p, len); int y = 0; unsigned mo = 0, d = 0, h = 0, mi = 0, sec = 0; char f[10] = "";
+        sscanf(s.c_str(), "%d-%u-%u%*1[ T]%u:%u:%u.%9[0-9]", &y, &mo, &d, &h, &mi, &sec, f);
+        LvTime t = {0, 0};  //  zero dates are the zero timestamp
+        if (mo) t = ToLvTime(y, mo, d, h * 3600LL + mi * 60 + sec, (uint32_t) atol((f + string(9 - strlen(f), '0')).c_str()));
+        return LVStr((char*) &t, sizeof(t));
+    }
+
+    template <class From> static tConv ConvTo(int t) {  //  converter from bound numeric to LV type "t", NULL if none
+        switch (t)
+        {
+        case Boolean: return NumConv<From, bool>;
+        case U8: return NumConv<From, uInt8>;
+        case I8: return NumConv<From, int8>;
+        case U16: return NumConv<From, uInt16>;
+        case I16: return NumConv<From, int16>;
+        case U32: return NumConv<From, uInt32>;
+        case I32: return NumConv<From, int32>;
+        case SGL: return NumConv<From, float>;
+        case DBL: return NumConv<From, double>;
+        case U64: return NumConv<From, uInt64>;
+        case I64: return NumConv<From, int64>;
+        case EXT: return ExtConv<From>;
+        case String: return TextConv<From>;
+        case Array: return RawConv<sizeof(From)>;   //  native bytes, as stored
+        default: return NULL;
+        }
+    }
+
+    static tConv TextTo(int t) {  //  converter from bound string/BLOB to LV type "t", NULL if none
+        switch (t)
+        {
+        case Boolean: return ParseConv<bool>;
+        case U8: return ParseConv<uInt8>;
+        case I8: return ParseConv<int8>;
+        case U16: return ParseConv<uInt16>;
+        case I16: return ParseConv<int16>;
+        case U32: return ParseConv<uInt32>;
+        case I32: return ParseConv<int32>;
+        case SGL: return ParseConv<float>;
+        case DBL: return ParseConv<double>;
+        case U64: return ParseConv<uInt64>;
+        case I64: return ParseConv<int64>;
+        case EXT: return ParseExt;
+        case Timestamp: return ParseTime;
+        case String: case Array: return StrConv;
+        default: return NULL;
+        }
+    }
+
+    static tConv NativeConv(int t) {  //  converter for a value already in LV type "t"
+        switch (TDSize(t))
+        {
+        case 1: return RawConv<1>;
+        case 2: return RawConv<2>;
+        case 4: return RawConv<4>;
+        case 8: return RawConv<8>;
+        default: return (t == String || t == Array ? StrConv : NULL);
+        }
+    }
+
+#ifdef MYAPI
+    static bool IsText(enum_field_types t) {  //  bound as text, DECIMAL too: exact, parsed by the converter if need be
+        return (t >= MYSQL_TYPE_TINY_BLOB && t <= MYSQL_TYPE_STRING) || t == MYSQL_TYPE_NEWDECIMAL || t == MYSQL_TYPE_DECIMAL;
+    }
+
+    static LvTime MyLvTime(const MYSQL_TIME* m) {  //  TIME is a duration from the LV epoch, zero dates the zero timestamp
+        bool date = (m->time_type != MYSQL_TIMESTAMP_TIME && m->month);
+        LvTime t = ToLvTime(date ? m->year : 1904, date ? m->month : 1, date ? m->day : 1,
+            m->hour * 3600LL + m->minute * 60 + m->second, (uint32_t) m->second_part * 1000);
+        if (m->neg) {t.sec = -t.sec - (t.frac != 0); t.frac = 0 - t.frac;}
+        return t;
+    }
+    static LStrHandle MyTimeStamp(const void* p, unsigned long len) {
+        LvTime t = MyLvTime((const MYSQL_TIME*) p); return LVStr((char*) &t, sizeof(t));
+    }
+    static LStrHandle MyTimeDbl(const void* p, unsigned long len) {  //  seconds since 1904, as LV converts timestamps
+        LvTime t = MyLvTime((const MYSQL_TIME*) p); double x = t.sec + t.frac / 18446744073709551616.0;
+        return LVStr((char*) &x, sizeof(x));
+    }
+    static LStrHandle MyTimeText(const void* p, unsigned long len) {  //  as MySQL prints it, fraction when non zero
+        const MYSQL_TIME* m = (const MYSQL_TIME*) p; char s[64]; int n;
+        if (m->time_type == MYSQL_TIMESTAMP_TIME) n = snprintf(s, sizeof(s), "%s%02u:%02u:%02u", m->neg ? "-" : "", m->hour, m->minute, m->second);
+        else n = snprintf(s, sizeof(s), "%04u-%02u-%02u", m->year, m->month, m->day);
+        if (m->time_type == MYSQL_TIMESTAMP_DATETIME) n += snprintf(s + n, sizeof(s) - n, " %02u:%02u:%02u", m->hour, m->minute, m->second);
+        if (m->second_part && m->time_type != MYSQL_TIMESTAMP_DATE) n += snprintf(s + n, sizeof(s) - n, ".%06lu", (unsigned long) m->second_part);
+        return LVStr(s, n);
+    }
+
+    static tConv MyConv(MYSQL_FIELD* f, int t) {  //  converter for MySQL field bound in its own type, NULL if unsupported
+        bool u = (f->flags & UNSIGNED_FLAG) != 0;
+        switch (f->type)
+        {
+        case MYSQL_TYPE_TINY: return u ? ConvTo<uInt8>(t) : ConvTo<int8>(t);
+        case MYSQL_TYPE_SHORT: return u ? ConvTo<uInt16>(t) : ConvTo<int16>(t);
+        case MYSQL_TYPE_YEAR: return ConvTo<uInt16>(t);
+        case MYSQL_TYPE_LONG: case MYSQL_TYPE_INT24: return u ? ConvTo<uInt32>(t) : ConvTo<int32>(t);
+        case MYSQL_TYPE_LONGLONG: return u ? ConvTo<uInt64>(t) : ConvTo<int64>(t);
+        case MYSQL_TYPE_FLOAT: return ConvTo<float>(t);
+        case MYSQL_TYPE_DOUBLE: return ConvTo<double>(t);
+        case MYSQL_TYPE_DATE: case MYSQL_TYPE_TIME: case MYSQL_TYPE_DATETIME: case MYSQL_TYPE_TIMESTAMP:  //  MYSQL_TIME
+            return (t == Timestamp ? MyTimeStamp : t == DBL ? MyTimeDbl : t == String ? MyTimeText : NULL);
+        case MYSQL_TYPE_DECIMAL: case MYSQL_TYPE_NEWDECIMAL:
+        case MYSQL_TYPE_TINY_BLOB ... MYSQL_TYPE_STRING: return TextTo(t);
+        default: return NULL;
+        }
+    }
+#endif
+
+#ifdef ODBCAPI
+    static SQLSMALLINT OdbcCType(int t) {  //  C type the driver converts a column to for LV type "t", 0 if unsupported
+        switch (t)
+        {
+        case Boolean: return SQL_C_BIT;
+        case U8: return SQL_C_UTINYINT;
+        case I8: return SQL_C_STINYINT;
+        case U16: return SQL_C_USHORT;
+        case I16: return SQL_C_SSHORT;
+        case U32: return SQL_C_ULONG;
+        case I32: return SQL_C_SLONG;
+        case SGL: return SQL_C_FLOAT;
+        case DBL: return SQL_C_DOUBLE;
+        case U64: return SQL_C_UBIGINT;
+        case I64: return SQL_C_SBIGINT;
+        case EXT: return SQL_C_CHAR;    //  decimal text, exact for DECIMAL/NUMERIC
+        case Timestamp: return SQL_C_TYPE_TIMESTAMP;
+        case String: return SQL_C_CHAR;
+        case Array: return SQL_C_BINARY;
+        default: return 0;
+        }
+    }
+
+    static LStrHandle OdbcTimeStamp(const void* p, unsigned long len) {  //  zero dates are the zero timestamp
+        const SQL_TIMESTAMP_STRUCT* m = (const SQL_TIMESTAMP_STRUCT*) p; LvTime t = {0, 0};
+        if (m->month) t = ToLvTime(m->year, m->month, m->day, m->hour * 3600LL + m->minute * 60 + m->second, m->fraction);
+        return LVStr((char*) &t, sizeof(t));
+    }
+    static tConv OdbcConv(int t) {  //  converter from OdbcCType(t)
+        return (t == EXT ? ParseExt : t == Timestamp ? OdbcTimeStamp : NativeConv(t));
+    }
+#endif
+
+    string TimeParam(LStrHandle v) {  //  timestamp cell as the API's date-time struct, to microseconds
+        LvTime t = {0, 0}; memcpy(&t, LStrBuf(v), min((size_t) LStrLen(v), sizeof(t)));
+        tCivil c = FromLvTime(t, 1000);
+        switch (type)
+        {
+#ifdef MYAPI
+        case MySQL: {
+            MYSQL_TIME m; memset(&m, 0, sizeof(m)); m.time_type = MYSQL_TIMESTAMP_DATETIME;
+            m.year = c.year; m.month = c.month; m.day = c.day; m.hour = c.hour; m.minute = c.minute; m.second = c.second;
+            m.second_part = c.ns / 1000;
+            return string((char*) &m, sizeof(m));}
+#endif
+#ifdef ODBCAPI
+        case ODBC:
+        case SqlServer: {
+            SQL_TIMESTAMP_STRUCT m = {(SQLSMALLINT) c.year, (SQLUSMALLINT) c.month, (SQLUSMALLINT) c.day,
+                (SQLUSMALLINT) c.hour, (SQLUSMALLINT) c.minute, (SQLUSMALLINT) c.second, c.ns};
+            return string((char*) &m, sizeof(m));}
+#endif
+        default:
+            return "";
+        }
+    }
+
+    int GetColumns(int cols, TypesHdl types, UHandle columns[], LStrArrayHdl nulls, UHandle* clusters = NULL) {  //  return results as one native LV array per column
+        //  or, given "clusters", as one LV array of clusters whose fields are "types" in order ("columns" unused)
+        errnum = 0; int rc;
+        int row = 0, rows = 0; //  row number, rows allocated in column arrays
+        vector<int> size(cols, 0), offset(cols, 0);
+        vector<double> res(cols, 0);    //  bound numeric buffers, 8 bytes holds any numeric TD
+        vector<string> str(cols);       //  bound string/BLOB buffers
+        vector<string> NullMap(cols);   //  bit (row % 8) of byte (row / 8) set when field is NULL
+        int stride = 0, align = 1;      //  cluster size and alignment
+        auto t0 = chrono::steady_clock::now(); chrono::steady_clock::duration fetch{0};
+#ifdef ODBCAPI
+        auto Fetch = [&] {auto tf = chrono::steady_clock::now(); SQLRETURN r = SQLFetch(api.odbc.hStmt);
+                          fetch += chrono::steady_clock::now() - tf; return r;};
+#endif
+
+        for (int i = 0; i < cols; i++)
+        {
+            int t = (**types).TypeDescriptor[i];
+            if (!(size[i] = TDSize(t)))
+                {errnum = -1; errstr = new string("Unsupported data type: " + to_string(t)); break;}
+            if (clusters)   //  field offsets, LV aligns cluster fields naturally except on 32-bit Windows (packed)
+            {
+#if defined(WIN) && !defined(_WIN64)
+                int a = 1;
+#else
+                int a = size[i];
+#endif
+                offset[i] = stride = (stride + a - 1) / a * a;
+                stride += size[i]; align = max(align, a);
+                continue;
+            }
+            if ((t == String || t == Array) && columns[i] != NULL)  //  free strings of caller's array before reuse
+            {
+                LStrArray* a = (LStrArray*) *columns[i];
+                for (int k = 0; k < a->dimSize; k++) if (a->elt[k]) DSDisposeHandle(a->elt[k]);
+                a->dimSize = 0;
+            }
+        }
+        if (clusters)
+        {
+            stride = (stride + align - 1) / align * align;
+            if (*clusters != NULL)  //  free strings of caller's array before reuse
+            {
+                LvArray<char>* a = (LvArray<char>*) **clusters;
+                for (int k = 0; k < a->dimSize; k++)
+                    for (int i = 0; i < cols; i++)
+                    {
+                        int t = (**types).TypeDescriptor[i];
+                        LStrHandle* h = (LStrHandle*) ((char*) a + LvArrayHdr(align) + (size_t) k * stride + offset[i]);
+                        if ((t == String || t == Array) && *h) DSDisposeHandle(*h);
+                    }
+                a->dimSize = 0;
+            }
+        }
+        auto Resize = [&](int n) {  //  (re)size all column arrays, new elements zeroed (NULL strings)
+            if (clusters)
+            {
+                if (LvArrayResize(clusters, stride, n, align)) return false;
+                if (n > rows) memset((char*) **clusters + LvArrayHdr(align) + (size_t) rows * stride, 0, (size_t) (n - rows) * stride);
+                rows = n; return true;
+            }
+            for (int i = 0; i < cols; i++)
+            {
+                if (LvArrayResize(&columns[i], size[i], n)) return false;
+                if (n > rows) memset((char*) *columns[i] + LvArrayHdr(size[i]) + (size_t) rows * size[i], 0, (size_t) (n - rows) * size[i]);
+            }
+            rows = n; return true;
+        };
+        auto Cell = [&](int i) {
+            if (clusters) return (char*) **clusters + LvArrayHdr(align) + (size_t) row * stride + offset[i];
+            return (char*) *columns[i] + LvArrayHdr(size[i]) + (size_t) row * size[i];};
+        auto SetNull = [&](int i) {
+            if (NullMap[i].length() <= (size_t) row / 8) NullMap[i].resize(row / 8 + 1, (char) 0);
+            NullMap[i][row / 8] |= 1 << (row % 8);
+        };
+
+        switch (type)
+        {
+#ifdef MYAPI
+        case MySQL: {
+            if (errnum) {StmtClose(api.my.stmt); return -1;}
+            if (!(api.my.query_results = mysql_stmt_result_metadata(api.my.stmt))) //  Fetch result set meta information
+                MYSQL_EXIT();
+            if ((unsigned int) cols != mysql_num_fields(api.my.query_results))
+                {errnum = -1; errstr = new string("Data column number mismatch");
+                 mysql_free_result(api.my.query_results); StmtClose(api.my.stmt); return -1;}
+            MYSQL_FIELD* fields; fields = mysql_fetch_fields(api.my.query_results);
+
+            int k = 1;
+            if (mysql_stmt_attr_set(api.my.stmt, STMT_ATTR_UPDATE_MAX_LENGTH, &k)) MYSQL_EXIT();
+            if (mysql_stmt_store_result(api.my.stmt)) MYSQL_EXIT();
+            stats.Time(tStats::Query, tStats::Fetch, t0);
+
+            vector<MYSQL_BIND> bind(cols); memset(&bind[0], 0, cols * sizeof(MYSQL_BIND));
+            vector<unsigned long> length(cols, 0);
+            vector<my_bool> is_null(cols, 0), error(cols, 0);
+#define CASE(xTD, sType, uType) case  xTD:\
+            bind[i].buffer_type = sType; bind[i].is_unsigned = uType; bind[i].buffer = &(res[i]);\
+            break;
+
+            for (int i = 0; i < cols; i++) {  //  bind buffers, libmysql converts to the requested LV type
+                int t = (**types).TypeDescriptor[i];
+                bind[i].is_null = &is_null[i]; bind[i].error = &error[i]; bind[i].length = &length[i];
+                switch (t)
+                {
+                CASE(Boolean, MYSQL_TYPE_TINY, 1)
+                CASE(U8, MYSQL_TYPE_TINY, 1)
+                CASE(I8, MYSQL_TYPE_TINY, 0)
+                CASE(U16, MYSQL_TYPE_SHORT, 1)
+                CASE(I16, MYSQL_TYPE_SHORT, 0)
+                CASE(U32, MYSQL_TYPE_LONG, 1)
+                CASE(I32, MYSQL_TYPE_LONG, 0)
+                CASE(U64, MYSQL_TYPE_LONGLONG, 1)
+                CASE(I64, MYSQL_TYPE_LONGLONG, 0)
+                CASE(SGL, MYSQL_TYPE_FLOAT, 0)
+                CASE(DBL, MYSQL_TYPE_DOUBLE, 0)
+                default:    //  String, Array (BLOB), longer values are read by MyFetchColumn()
+                    str[i] = string(MyBufLen(&fields[i]), (char) 0);
+                    bind[i].buffer_type = (t == String ? MYSQL_TYPE_STRING : MYSQL_TYPE_BLOB);
+                    bind[i].buffer = (char*) str[i].c_str(); bind[i].buffer_length = str[i].length();
+                    break;
+                }
+            }
+#undef CASE
+            if (mysql_stmt_bind_result(api.my.stmt, &bind[0])) MYSQL_EXIT();
+            if (!Resize(mysql_stmt_num_rows(api.my.stmt)))  //  row count is known after store, size arrays once
+                {errnum = -1; errstr = new string("Out of memory");
+                 mysql_free_result(api.my.query_results); StmtClose(api.my.stmt); return -1;}
+
+            while ((rc = mysql_stmt_fetch(api.my.stmt)) != 1) {  //  Fetch all rows
+                if (rc == MYSQL_NO_DATA) break;
+                for (int i = 0; i < cols; i++)
+                {
+                    int t = (**types).TypeDescriptor[i];
+                    if (is_null[i]) {SetNull(i); continue;}
+                    if (t == String || t == Array)
+                    {
+                        if (length[i] > str[i].length())
+                           {if (!(*(LStrHandle*) Cell(i) = MyFetchColumn(api.my.stmt, &bind[i], i, length[i])))
+                                {mysql_free_result(api.my.query_results); StmtClose(api.my.stmt); return -1;}}
+                        else *(LStrHandle*) Cell(i) = LVStr((char*) str[i].c_str(), length[i]);
+                    }
+                    else memcpy(Cell(i), &(res[i]), size[i]);
+                }
+                row++;
+            }
+            if (rc == 1) MYSQL_EXIT();
+
+            mysql_free_result(api.my.query_results);
+            if (StmtClose(api.my.stmt))
+                {errnum = mysql_errno(api.my.con); errstr = new string(mysql_error(api.my.con)); return -1;}
+            break;}
+#endif
+
+#ifdef ODBCAPI
+        case ODBC:
+        case SqlServer: {
+            if (errnum) {StmtClose(api.odbc.hStmt); return -1;}
+            vector<SQLLEN> DataLen(cols, 0); vector<SQLSMALLINT> CType(cols, 0);
+            int FirstUnbound; FirstUnbound = cols;  //  string/BLOB buffers from column octet length, the first column too long
+            for (SQLUSMALLINT i = 0; i < cols; i++) //  for StrBufLen, and all after it, are read with SQLGetData()
+            {
+                int t = (**types).TypeDescriptor[i];
+                if (t != String && t != Array) continue;
+                SQLLEN len = OdbcBufLen(api.odbc.hStmt, i + 1, t);
+                if (!len) {FirstUnbound = i; break;}
+                str[i] = string(len, (char) 0);
+            }
+#define CASE(xTD, sType) case  xTD:\
+            CType[i] = sType;\
+            if (i < FirstUnbound) rc = SQLBindCol(api.odbc.hStmt, i + 1, sType, &(res[i]), size[i], &(DataLen[i]));\
+            break;
+
+            for (SQLUSMALLINT i = 0; i < cols; i++)
+            {
+                int t = (**types).TypeDescriptor[i];
+                rc = SQL_SUCCESS;
+                switch (t)
+                {
+                CASE(Boolean, SQL_C_BIT)
+                CASE(U8, SQL_C_UTINYINT)
+                CASE(I8, SQL_C_STINYINT)
+                CASE(U16, SQL_C_USHORT)
+                CASE(I16, SQL_C_SSHORT)
+                CASE(U32, SQL_C_ULONG)
+                CASE(I32, SQL_C_SLONG)
+                CASE(U64, SQL_C_UBIGINT)
+                CASE(I64, SQL_C_SBIGINT)
+                CASE(SGL, SQL_C_FLOAT)
+                CASE(DBL, SQL_C_DOUBLE)
+                default:    //  String, Array (BLOB)
+                    if (i < FirstUnbound)
+                        rc = SQLBindCol(api.odbc.hStmt, i + 1, (t == String ? SQL_C_CHAR: SQL_C_BINARY),
+                                    (char*) str[i].c_str(), str[i].length(), &(DataLen[i]));
+                    break;
+                }
+                if (rc == SQL_ERROR)
+                    {ODBC_ERROR(SQL_HANDLE_STMT, api.odbc.hStmt, "Column " + to_string(i + 1) + "; type " + to_string(t));
+                     StmtClose(api.odbc.hStmt); return -1;}
+            }
+#undef CASE
+
+            while ((rc = Fetch()) != SQL_NO_DATA)
+            {
+                if (rc == SQL_ERROR)
+                    {ODBC_ERROR(SQL_HANDLE_STMT, api.odbc.hStmt, "");
+                     StmtClose(api.odbc.hStmt); return -1;}
+                if (row == rows && !Resize(rows ? 2 * rows : 1024)) //  row count unknown, grow geometrically
+                    {errnum = -1; errstr = new string("Out of memory");
+                     StmtClose(api.odbc.hStmt); return -1;}
+                for (SQLUSMALLINT i = 0; i < cols; i++)
+                {
+                    int t = (**types).TypeDescriptor[i];
+                    if (i >= FirstUnbound)  //  unbound, strings in StrBlobLen chunks
+                    {
+                        string val; bool null = false;
+                        if (t == String || t == Array) rc = OdbcGetData(api.odbc.hStmt, i + 1, t, val, null);
+                        else {rc = SQLGetData(api.odbc.hStmt, i + 1, CType[i], &(res[i]), size[i], &(DataLen[i]));
+                              null = (DataLen[i] == SQL_NULL_DATA);}
+                        if (rc == SQL_ERROR)
+                            {ODBC_ERROR(SQL_HANDLE_STMT, api.odbc.hStmt, "");
+                             StmtClose(api.odbc.hStmt); return -1;}
+                        if (null) SetNull(i);
+                        else if (t == String || t == Array) *(LStrHandle*) Cell(i) = LVStr(val);
+                        else memcpy(Cell(i), &(res[i]), size[i]);
+                        continue;
+                    }
+                    if (DataLen[i] == SQL_NULL_DATA) {SetNull(i); continue;}
+                    if (t == String || t == Array)
+                    {
+                        if (DataLen[i] == SQL_NO_TOTAL || DataLen[i] > (SQLLEN) str[i].length() - (t == String ? 1 : 0))
+                            {errnum = -1; errstr = new string("Driver reported short column length, column:" + to_string(i + 1) + ", use SetBufLen(0)");
+                             StmtClose(api.odbc.hStmt); return -1;}
+                        *(LStrHandle*) Cell(i) = LVStr((char*) str[i].c_str(), DataLen[i]);
+                    }
+                    else memcpy(Cell(i), &(res[i]), size[i]);
+                }
+                row++;
+            }
+            StmtClose(api.odbc.hStmt);
+            break;}
+#endif
+
+        default:
+            errnum = -1; errstr = new string("Columnar results not supported for this RDBMS"); return -1;
+            break;
+        }
+
+        if (!Resize(row)) {errnum = -1; errstr = new string("Out of memory"); return -1;}  //  trim to rows fetched
+        for (int i = 0; i < (**nulls).dimSize; i++) if ((**nulls).elt[i]) DSDisposeHandle((**nulls).elt[i]);
+        if (DSSetHandleSize(nulls, LvArrayHdr(sizeof(LStrHandle)) + cols * sizeof(LStrHandle)) != mgNoErr)
+            {errnum = -1; errstr = new string("Out of memory"); return -1;}
+        (**nulls).dimSize = cols;
+        for (int i = 0; i < cols; i++)
+            {NullMap[i].resize((row + 7) / 8, (char) 0); (**nulls).elt[i] = LVStr(NullMap[i]);
+             if ((**types).TypeDescriptor[i] != String && (**types).TypeDescriptor[i] != Array)
+                LvBytes += (uint64_t) row * size[i];}    //  numerics written in place, strings counted by LVStr()
+        stats.Split(tStats::Query, t0, fetch);
+        return row;
+    }
+
+    int QueryOpen(string query, TypesHdl types) {  //  run query, leave results on the wire to be read by FetchChunk()
+        if (cursor.open) QueryClose();
+        errnum = -1; errdata = new string(query);
+        if (query.length() < 1) { errstr = new string("Query string may not be blank"); return -1; }
+        int cols = cursor.cols = (**types).dimSize;
+        cursor.td.assign((**types).TypeDescriptor, (**types).TypeDescriptor + cols);
+        for (int i = 0; i < cols; i++)
+            if (!TDSize(cursor.td[i])) {errstr = new string("Unsupported data type: " + to_string(cursor.td[i])); return -1;}
+        cursor.res.assign(cols, 0); cursor.str.assign(cols, string());
+
+        switch (type)
+        {
+#ifdef MYAPI
+        case MySQL: {
+            if (api.my.con == NULL) { errstr = new string("Connection closed"); return -1; }
+            if (!(cursor.stmt = mysql_stmt_init(api.my.con)))
+                {errnum = -1; errstr = new string("Out of memory"); return -1;}
+            if (mysql_stmt_prepare(cursor.stmt, query.c_str(), query.length()) || mysql_stmt_execute(cursor.stmt))
+                {errnum = mysql_errno(api.my.con); errstr = new string(mysql_error(api.my.con));
+                 mysql_stmt_close(cursor.stmt); return -1;}
+            MYSQL_RES* meta; unsigned int n; n = 0;
+            vector<unsigned long> ColLen; ColLen.assign(cols, 0);  //  declared column lengths, bound buffers no larger
+            if ((meta = mysql_stmt_result_metadata(cursor.stmt)))
+               {n = mysql_num_fields(meta); MYSQL_FIELD* f = mysql_fetch_fields(meta);
+                for (unsigned int i = 0; i < n && i < (unsigned) cols; i++) ColLen[i] = f[i].length;
+                mysql_free_result(meta);}
+            if ((unsigned) cols != n)
+                {errnum = -1; errstr = new string("Data column number mismatch"); mysql_stmt_close(cursor.stmt); return -1;}
+
+            //  no mysql_stmt_store_result(), rows are read from the connection as they are fetched
+            cursor.bind.assign(cols, MYSQL_BIND()); memset(&cursor.bind[0], 0, cols * sizeof(MYSQL_BIND));
+            cursor.length.assign(cols, 0); cursor.is_null.assign(cols, 0); cursor.error.assign(cols, 0);
+#define CASE(xTD, sType, uType) case  xTD:\
+            b.buffer_type = sType; b.is_unsigned = uType; b.buffer = &(cursor.res[i]);\
+            break;
+
+            for (int i = 0; i < cols; i++) {  //  bind buffers, libmysql converts to the requested LV type
+                MYSQL_BIND& b = cursor.bind[i];
+                b.is_null = &cursor.is_null[i]; b.error = &cursor.error[i]; b.length = &cursor.length[i];
+                switch (cursor.td[i])
+                {
+                CASE(Boolean, MYSQL_TYPE_TINY, 1)
+                CASE(U8, MYSQL_TYPE_TINY, 1)
+                CASE(I8, MYSQL_TYPE_TINY, 0)
+                CASE(U16, MYSQL_TYPE_SHORT, 1)
+                CASE(I16, MYSQL_TYPE_SHORT, 0)
+                CASE(U32, MYSQL_TYPE_LONG, 1)
+                CASE(I32, MYSQL_TYPE_LONG, 0)
+                CASE(U64, MYSQL_TYPE_LONGLONG, 1)
+                CASE(I64, MYSQL_TYPE_LONGLONG, 0)
+                CASE(SGL, MYSQL_TYPE_FLOAT, 0)
+                CASE(DBL, MYSQL_TYPE_DOUBLE, 0)
+                default:    //  String, Array (BLOB); longer values are picked up by mysql_stmt_fetch_column()
+                    cursor.str[i] = string(StrBufLen > 0 ? min(ColLen[i], (unsigned long) StrBufLen) : 0, (char) 0);
+                    b.buffer_type = (cursor.td[i] == String ? MYSQL_TYPE_STRING : MYSQL_TYPE_BLOB);
+                    b.buffer = (char*) cursor.str[i].c_str(); b.buffer_length = cursor.str[i].length();
+                    break;
+                }
+            }
+#undef CASE
+            if (mysql_stmt_bind_result(cursor.stmt, &cursor.bind[0]))
+                {errnum = mysql_errno(api.my.con); errstr = new string(mysql_error(api.my.con));
+                 mysql_stmt_close(cursor.stmt); return -1;}
+            cursor.open = true; errnum = 0;
+            break;}
+#endif
+
+#ifdef ODBCAPI
+        case ODBC:
+        case SqlServer: {
+            if (api.odbc.hDbc == NULL) { errstr = new string("Connection closed"); return -1; }
+            if (SQLAllocHandle(SQL_HANDLE_STMT, api.odbc.hDbc, &(cursor.hStmt)) == SQL_ERROR)
+                {ODBC_ERROR(SQL_HANDLE_DBC, api.odbc.hDbc, query); return -1;}
+            StmtTimeout(cursor.hStmt);
+            if (SQLExecDirect(cursor.hStmt, (SQLCHAR*)query.c_str(), SQL_NTS) == SQL_ERROR)
+                {ODBC_ERROR(SQL_HANDLE_STMT, cursor.hStmt, query);
+                 SQLFreeHandle(SQL_HANDLE_STMT, cursor.hStmt); return -1;}
+            cursor.DataLen.assign(cols, 0); cursor.CType.assign(cols, 0);
+            cursor.FirstUnbound = cols;     //  string/BLOB buffers from column octet length, see GetResults()
+            for (SQLUSMALLINT i = 0; i < cols; i++)
+            {
+                int t = cursor.td[i];
+                if (t != String && t != Array) continue;
+                SQLLEN len = OdbcBufLen(cursor.hStmt, i + 1, t);
+                if (!len) {cursor.FirstUnbound = i; break;}
+                cursor.str[i] = string(len, (char) 0);
+            }
+#define CASE(xTD, sType) case  xTD:\
+            cursor.CType[i] = sType;\
+            if (i < cursor.FirstUnbound) rc = SQLBindCol(cursor.hStmt, i + 1, sType, &(cursor.res[i]), TDSize(xTD), &(cursor.DataLen[i]));\
+            break;
+
+            for (SQLUSMALLINT i = 0; i < cols; i++)
+            {
+                int rc = SQL_SUCCESS, t = cursor.td[i];
+                switch (t)
+                {
+                CASE(Boolean, SQL_C_BIT)
+                CASE(U8, SQL_C_UTINYINT)
+                CASE(I8, SQL_C_STINYINT)
+                CASE(U16, SQL_C_USHORT)
+                CASE(I16, SQL_C_SSHORT)
+                CASE(U32, SQL_C_ULONG)
+                CASE(I32, SQL_C_SLONG)
+                CASE(U64, SQL_C_UBIGINT)
+                CASE(I64, SQL_C_SBIGINT)
+                CASE(SGL, SQL_C_FLOAT)
+                CASE(DBL, SQL_C_DOUBLE)
+                default:    //  String, Array (BLOB)
+                    if (i < cursor.FirstUnbound)
+                        rc = SQLBindCol(cursor.hStmt, i + 1, (t == String ? SQL_C_CHAR: SQL_C_BINARY),
+                                    (char*) cursor.str[i].c_str(), cursor.str[i].length(), &(cursor.DataLen[i]));
+                    break;
+                }
+                if (rc == SQL_ERROR)
+                    {ODBC_ERROR(SQL_HANDLE_STMT, cursor.hStmt, "Column " + to_string(i + 1) + "; type " + to_string(t));
+                     SQLFreeHandle(SQL_HANDLE_STMT, cursor.hStmt); return -1;}
+            }
+#undef CASE
+            cursor.open = true; errnum = 0;
+            break;}
+#endif
+
+        default:
+            errnum = -1; errstr = new string("Streaming queries not supported for this RDBMS");
+            break;
+        }
+        return errnum;
+    }
+
+    int FetchChunk(int n, ResultSetHdl results) {  //  return up to n rows of the open query as LV flattened strings, 0 at end
+        if (!cursor.open) {errnum = -1; errstr = new string("No open query, use QueryOpen"); return -1;}
+        errnum = 0; int rc, row = 0, cols = cursor.cols;
+        if (n < 1) {errnum = -1; errstr = new string("Chunk size must be positive"); return -1;}
+        for (long k = 0; k < (**results).dimSizes[0] * (**results).dimSizes[1]; k++)  //  strings of the previous chunk, buffer reused
+            if ((**results).elt[k]) DSDisposeHandle((**results).elt[k]);
+        (**results).dimSizes[0] = 0;
+        if (DSSetHandleSize(results, offsetof(ResultSet, elt) + (size_t) n * cols * sizeof(LStrHandle)) != mgNoErr)
+            {errnum = -1; errstr = new string("Out of memory"); return -1;}
+        memset((**results).elt, 0, (size_t) n * cols * sizeof(LStrHandle));  //  NULL fields stay NULL strings
+
+        switch (type)
+        {
+#ifdef MYAPI
+        case MySQL:
+            while (row < n && (rc = mysql_stmt_fetch(cursor.stmt)) != MYSQL_NO_DATA) {
+                if (rc == 1)
+                    {errnum = mysql_stmt_errno(cursor.stmt); errstr = new string(mysql_stmt_error(cursor.stmt)); break;}
+                for (int i = 0; i < cols; i++)
+                {
+                    int t = cursor.td[i]; LStrHandle* cell = &(**results).elt[row * cols + i];
+                    if (cursor.is_null[i]) continue;
+                    if (t != String && t != Array) {*cell = LVStr((char*) &(cursor.res[i]), TDSize(t)); continue;}
+                    if (cursor.length[i] <= cursor.str[i].length())
+                        {*cell = LVStr((char*) cursor.str[i].c_str(), cursor.length[i]); continue;}
+                    if (!(*cell = MyFetchColumn(cursor.stmt, &cursor.bind[i], i, cursor.length[i]))) break;  //  larger than bound buffer
+                }
+                if (errnum) break;
+                row++;
+            }
+            break;
+#endif
+
+#ifdef ODBCAPI
+        case ODBC:
+        case SqlServer:
+            while (row < n && (rc = SQLFetch(cursor.hStmt)) != SQL_NO_DATA)
+            {
+                if (rc == SQL_ERROR) {ODBC_ERROR(SQL_HANDLE_STMT, cursor.hStmt, ""); break;}
+                for (SQLUSMALLINT i = 0; i < cols; i++)
+                {
+                    int t = cursor.td[i]; LStrHandle* cell = &(**results).elt[row * cols + i];
+                    if (i >= cursor.FirstUnbound)   //  unbound, strings in StrBlobLen chunks
+                    {
+                        string val; bool null = false;
+                        if (t == String || t == Array) rc = OdbcGetData(cursor.hStmt, i + 1, t, val, null);
+                        else {rc = SQLGetData(cursor.hStmt, i + 1, cursor.CType[i], &(cursor.res[i]), TDSize(t), &(cursor.DataLen[i]));
+                              null = (cursor.DataLen[i] == SQL_NULL_DATA);}
+                        if (rc == SQL_ERROR) {ODBC_ERROR(SQL_HANDLE_STMT, cursor.hStmt, ""); break;}
+                        if (null) continue;
+                        *cell = (t == String || t == Array) ? LVStr(val) : LVStr((char*) &(cursor.res[i]), TDSize(t));
+                        continue;
+                    }
+                    if (cursor.DataLen[i] == SQL_NULL_DATA) continue;
+                    if (t != String && t != Array) {*cell = LVStr((char*) &(cursor.res[i]), TDSize(t)); continue;}
+                    if (cursor.DataLen[i] == SQL_NO_TOTAL || cursor.DataLen[i] > (SQLLEN) cursor.str[i].length() - (t == String ? 1 : 0))
+                        {errnum = -1; errstr = new string("Driver reported short column length, column:" + to_string(i + 1) + ", use SetBufLen(0)"); break;}
+                    *cell = LVStr((char*) cursor.str[i].c_str(), cursor.DataLen[i]);
+                }
+                if (errnum) break;
+                row++;
+            }
+            break;
+#endif
+
+        default:
+            errnum = -1; errstr = new string("Streaming queries not supported for this RDBMS");
+            break;
+        }
+
+        if (errnum) row = 0;    //  discard partial chunk
+        for (int k = row * cols; k < n * cols; k++) if ((**results).elt[k]) DSDisposeHandle((**results).elt[k]);
+        DSSetHandleSize(results, offsetof(ResultSet, elt) + (size_t) row * cols * sizeof(LStrHandle));
+        (**results).dimSizes[0] = row; (**results).dimSizes[1] = cols;
+        return errnum ? -1 : row;
+    }
+
+    int QueryClose() {  //  discard remaining rows of the open query and free statement
+        if (!cursor.open) return 0;
+        cursor.open = false;
+        switch (type)
+        {
+#ifdef MYAPI
+        case MySQL:
+            if (mysql_stmt_close(cursor.stmt))
+                {errnum = mysql_errno(api.my.con); errstr = new string(mysql_error(api.my.con)); return -1;}
+            break;
+#endif
+
+#ifdef ODBCAPI
+        case ODBC:
+        case SqlServer:
+            SQLFreeHandle(SQL_HANDLE_STMT, cursor.hStmt);
+            break;
+#endif
+
+        default:
+            break;
+        }
+        return 0;
+    }
+
+#ifdef ODBCAPI
+    SQLRETURN BlobParamData() {  //  finish parameter being streamed, the driver names the next one or, after the last, executes
+        if (blob.col >= 0 && blob.col < blob.n && !blob.sent) SQLPutData(blob.hStmt, (SQLPOINTER) "", 0);  //  no chunks, empty value
+        SQLPOINTER p = NULL; SQLRETURN rc = SQLParamData(blob.hStmt, &p);
+        blob.col = (rc == SQL_NEED_DATA ? (int) (uintptr_t) p - 1 : blob.n); blob.sent = false;
+        return rc;
+    }
+#endif
+
+    int BlobWriteBegin(string query, TypesHdl types) {  //  prepare statement whose parameters are all streamed by BlobWriteChunk()
+        if (blob.mode) BlobClose(true);
+        errnum = -1; errdata = new string(query); ResultInvalidate(query);
+        if (query.length() < 1) { errstr = new string("Query string may not be blank"); return -1; }
+        if (cursor.open) { errstr = new string("Connection has an open query, use QueryClose"); return -1; }
+        int n = blob.n = (**types).dimSize;
+        for (int i = 0; i < n; i++)
+            if ((**types).TypeDescriptor[i] != String && (**types).TypeDescriptor[i] != Array)
+                {errstr = new string("Streamed parameters must be String or BLOB, parameter " + to_string(i)); return -1;}
+        blob.col = -1; blob.pos = 0; blob.sent = false;
+
+        switch (type)
+        {
+#ifdef MYAPI
+        case MySQL:
+            if (api.my.con == NULL) { errstr = new string("Connection closed"); return -1; }
+            if (!(blob.stmt = MyPrepare(query, false))) return -1;  //  not cached, eviction or a rebind would pull it from under us
+            if (mysql_stmt_param_count(blob.stmt) != (unsigned long) n)
+                {errstr = new string("Parameter number mismatch"); StmtClose(blob.stmt); return -1;}
+            blob.bind.assign(n, MYSQL_BIND()); if (n) memset(&blob.bind[0], 0, n * sizeof(MYSQL_BIND));
+            for (int i = 0; i < n; i++)     //  no buffers, chunks go to the server by mysql_stmt_send_long_data(), unsent values are empty
+                blob.bind[i].buffer_type = ((**types).TypeDescriptor[i] == String ? MYSQL_TYPE_STRING : MYSQL_TYPE_LONG_BLOB);
+            if (n && mysql_stmt_bind_param(blob.stmt, &blob.bind[0]))
+                {errnum = mysql_stmt_errno(blob.stmt); errstr = new string(mysql_stmt_error(blob.stmt));
+                 StmtClose(blob.stmt); return -1;}
+            blob.mode = 1; errnum = 0;
+            break;
+#endif
+
+#ifdef ODBCAPI
+        case ODBC:
+        case SqlServer: {
+            if (api.odbc.hDbc == NULL) { errstr = new string("Connection closed"); return -1; }
+            if (!(blob.hStmt = OdbcPrepare(query, false))) return -1;
+            blob.ind.assign(n, SQL_DATA_AT_EXEC);   //  total length unknown up front
+            for (SQLUSMALLINT i = 0; i < n; i++)    //  value pointer is the parameter number, handed back by SQLParamData()
+            {
+                bool s = ((**types).TypeDescriptor[i] == String);
+                if (SQLBindParameter(blob.hStmt, i + 1, SQL_PARAM_INPUT, (s ? SQL_C_CHAR : SQL_C_BINARY), (s ? SQL_LONGVARCHAR : SQL_LONGVARBINARY),
+                        0, 0, (SQLPOINTER) (uintptr_t) (i + 1), 0, &blob.ind[i]) == SQL_ERROR)
+                    {ODBC_ERROR(SQL_HANDLE_STMT, blob.hStmt, query); StmtClose(blob.hStmt); return -1;}
+            }
+            SQLRETURN rc = SQLExecute(blob.hStmt);  //  returns SQL_NEED_DATA, the statement runs once the last parameter is sent
+            if (rc == SQL_NEED_DATA) rc = BlobParamData();
+            else blob.col = n;
+            if (rc == SQL_ERROR) {ODBC_ERROR(SQL_HANDLE_STMT, blob.hStmt, query); StmtClose(blob.hStmt); return -1;}
+            blob.mode = 1; errnum = 0;
+            break;}
+#endif
+
+        default:
+            errnum = -1; errstr = new string("BLOB streaming not supported for this RDBMS");
+            break;
+        }
+        return errnum;
+    }
+
+    int BlobWriteChunk(int param, LStrHandle chunk) {  //  append chunk to parameter, sent to the server at once and not kept
+        if (blob.mode != 1) {errnum = -1; errstr = new string("No BLOB write, use BlobWriteBegin"); return -1;}
+        if (param < 0 || param >= blob.n) {errnum = -1; errstr = new string("Parameter out of range: " + to_string(param)); return -1;}
+        errnum = 0; int len = LStrLen(chunk);
+        stats.Count(tStats::Update, tStats::BytesOut, len);
+        switch (type)
+        {
+#ifdef MYAPI
+        case MySQL:
+            if (len && mysql_stmt_send_long_data(blob.stmt, param, LStrBuf(chunk), len))
+                {errnum = mysql_stmt_errno(blob.stmt); errstr = new string(mysql_stmt_error(blob.stmt));}
+            break;
+#endif
+
+#ifdef ODBCAPI
+        case ODBC:
+        case SqlServer: {
+            if (param < blob.col)
+                {errnum = -1; errstr = new string("ODBC streams parameters in order, parameter " + to_string(param) + " already sent"); break;}
+            SQLRETURN rc = SQL_NEED_DATA;
+            while (blob.col < param && (rc = BlobParamData()) == SQL_NEED_DATA);
+            if (rc == SQL_ERROR) {ODBC_ERROR(SQL_HANDLE_STMT, blob.hStmt, ""); break;}
+            if (blob.col != param)
+                {errnum = -1; errstr = new string("Parameter " + to_string(param) + " not requested by driver"); break;}
+            if (len && SQLPutData(blob.hStmt, LStrBuf(chunk), len) == SQL_ERROR) {ODBC_ERROR(SQL_HANDLE_STMT, blob.hStmt, ""); break;}
+            blob.sent = true;
+            break;}
+#endif
+
+        default:
+            break;
+        }
+        if (errnum) BlobClose(true);   //  statement can't be completed, discard what was sent
+        return errnum ? -1 : 0;
+    }
+
+    int BlobWriteEnd(bool cancel) {  //  execute statement with the streamed parameters and return num rows affected, or discard them
+        if (blob.mode != 1) {errnum = -1; errstr = new string("No BLOB write, use BlobWriteBegin"); return -1;}
+        if (cancel) return BlobClose(true);
+        errnum = 0; int rows = 0;
+        switch (type)
+        {
+#ifdef MYAPI
+        case MySQL:
+            if (mysql_stmt_execute(blob.stmt)) {errnum = mysql_stmt_errno(blob.stmt); errstr = new string(mysql_stmt_error(blob.stmt));}
+            else rows = mysql_stmt_affected_rows(blob.stmt);
+            break;
+#endif
+
+#ifdef ODBCAPI
+        case ODBC:
+        case SqlServer: {
+            SQLRETURN rc = SQL_SUCCESS;
+            while (blob.col < blob.n && (rc = BlobParamData()) == SQL_NEED_DATA);    //  last one returns the result of execution
+            if (rc == SQL_ERROR) {ODBC_ERROR(SQL_HANDLE_STMT, blob.hStmt, ""); break;}
+            SQLLEN n = 0; SQLRowCount(blob.hStmt, &n); rows = n;
+            break;}
+#endif
+
+        default:
+            break;
+        }
+        BlobClose(errnum != 0);
+        return errnum ? -1 : rows;
+    }
+
+    int BlobReadOpen(string query) {  //  run query and stay on its first row, columns are read piecewise by BlobRead()
+        if (blob.mode) BlobClose(true);     //  return number of columns, 0 if no row
+        errnum = -1; errdata = new string(query);
+        if (query.length() < 1) { errstr = new string("Query string may not be blank"); return -1; }
+        if (cursor.open) { errstr = new string("Connection has an open query, use QueryClose"); return -1; }
+        blob.col = 0; blob.pos = 0;
+
+        switch (type)
+        {
+#ifdef MYAPI
+        case MySQL: {
+            if (api.my.con == NULL) { errstr = new string("Connection closed"); return -1; }
+            if (!(blob.stmt = mysql_stmt_init(api.my.con)))
+                {errnum = -1; errstr = new string("Out of memory"); return -1;}
+            if (mysql_stmt_prepare(blob.stmt, query.c_str(), query.length()) || mysql_stmt_execute(blob.stmt))
+                {errnum = mysql_errno(api.my.con); errstr = new string(mysql_error(api.my.con));
+                 mysql_stmt_close(blob.stmt); return -1;}
+            int n = blob.n = mysql_stmt_field_count(blob.stmt);
+
+            //  no buffers and no mysql_stmt_store_result(), fetch only gets the lengths and the row stays
+            //  in the client's network buffer, to be copied out piecewise by mysql_stmt_fetch_column()
+            blob.bind.assign(n, MYSQL_BIND()); if (n) memset(&blob.bind[0], 0, n * sizeof(MYSQL_BIND));
+            blob.length.assign(n, 0); blob.is_null.assign(n, 0);
+            for (int i = 0; i < n; i++)
+               {blob.bind[i].buffer_type = MYSQL_TYPE_BLOB; blob.bind[i].length = &blob.length[i]; blob.bind[i].is_null = &blob.is_null[i];}
+            int rc = 0;
+            if ((n && mysql_stmt_bind_result(blob.stmt, &blob.bind[0])) || (rc = mysql_stmt_fetch(blob.stmt)) == 1)
+                {errnum = mysql_stmt_errno(blob.stmt); errstr = new string(mysql_stmt_error(blob.stmt));
+                 mysql_stmt_close(blob.stmt); return -1;}
+            if (rc == MYSQL_NO_DATA) blob.n = 0;
+            blob.mode = 2; errnum = 0;
+            break;}
+#endif
+
+#ifdef ODBCAPI
+        case ODBC:
+        case SqlServer: {
+            if (api.odbc.hDbc == NULL) { errstr = new string("Connection closed"); return -1; }
+            if (SQLAllocHandle(SQL_HANDLE_STMT, api.odbc.hDbc, &(blob.hStmt)) == SQL_ERROR)
+                {ODBC_ERROR(SQL_HANDLE_DBC, api.odbc.hDbc, query); return -1;}
+            StmtTimeout(blob.hStmt);
+            SQLRETURN rc; SQLSMALLINT n = 0;
+            if (SQLExecDirect(blob.hStmt, (SQLCHAR*)query.c_str(), SQL_NTS) == SQL_ERROR ||
+                SQLNumResultCols(blob.hStmt, &n) == SQL_ERROR || (rc = SQLFetch(blob.hStmt)) == SQL_ERROR)   //  nothing bound,
+                {ODBC_ERROR(SQL_HANDLE_STMT, blob.hStmt, query);                                            //  read by SQLGetData()
+                 SQLFreeHandle(SQL_HANDLE_STMT, blob.hStmt); return -1;}
+            blob.n = (rc == SQL_NO_DATA ? 0 : n);
+            blob.mode = 2; errnum = 0;
+            break;}
+#endif
+
+        default:
+            errnum = -1; errstr = new string("BLOB streaming not supported for this RDBMS");
+            break;
+        }
+        return errnum ? -1 : blob.n;
+    }
+
+    int BlobRead(int col, int64_t offset, int len, LStrHandle* data) {  //  read up to "len" bytes of column from "offset" into data,
+        //  return bytes read, 0 past the end or if NULL; "data" is only grown, so a read loop streams through one buffer
+        if (blob.mode != 2) {errnum = -1; errstr = new string("No BLOB query, use BlobReadOpen"); return -1;}
+        errnum = -1;
+        if (col < 0 || col >= blob.n) {errstr = new string("Column out of range: " + to_string(col)); return -1;}
+        if (offset < 0 || len < 0) {errstr = new string("Offset and length may not be negative"); return -1;}
+        if (*data == NULL) {if ((*data = (LStrHandle) DSNewHClr(sizeof(int32) + len)) == NULL) {errstr = new string("Out of memory"); return -1;}}
+        else if (DSGetHandleSize(*data) < (int32) (sizeof(int32) + len) && DSSetHandleSize(*data, sizeof(int32) + len) != mgNoErr)
+            {errstr = new string("Out of memory"); return -1;}
+        (**data)->cnt = 0; errnum = 0; int got = 0;
+        if (len == 0) return 0;
+
+        switch (type)
+        {
+#ifdef MYAPI
+        case MySQL: {   //  random access, any column and offset
+            if (blob.is_null[col] || (unsigned long) offset >= blob.length[col]) break;
+            MYSQL_BIND b = blob.bind[col]; unsigned long n = 0;
+            got = min((unsigned long) len, blob.length[col] - (unsigned long) offset);
+            b.buffer = (**data)->str; b.buffer_length = got; b.length = &n;
+            if (mysql_stmt_fetch_column(blob.stmt, &b, col, offset))
+                {errnum = mysql_stmt_errno(blob.stmt); errstr = new string(mysql_stmt_error(blob.stmt));}
+            break;}
+#endif
+
+#ifdef ODBCAPI
+        case ODBC:
+        case SqlServer: {   //  SQLGetData() continues where the last call stopped, columns and offsets only go forward
+            if (col < blob.col) {errnum = -1; errstr = new string("ODBC reads columns in order, column " + to_string(col) + " already read"); break;}
+            if (col > blob.col) {blob.col = col; blob.pos = 0;}
+            if (offset < blob.pos) {errnum = -1; errstr = new string("ODBC reads forward only, offset before " + to_string(blob.pos)); break;}
+            auto Get = [&](int want) {  //  next "want" bytes of column into data, 0 at end
+                SQLLEN ind = 0; SQLRETURN rc = SQLGetData(blob.hStmt, col + 1, SQL_C_BINARY, (**data)->str, want, &ind);
+                if (rc == SQL_NO_DATA) return 0;
+                if (rc == SQL_ERROR) {ODBC_ERROR(SQL_HANDLE_STMT, blob.hStmt, ""); return 0;}
+                int n = (ind == SQL_NULL_DATA ? 0 : (ind == SQL_NO_TOTAL || ind > want) ? want : (int) ind);
+                blob.pos += n; return n;
+            };
+            while (!errnum && blob.pos < offset && Get((int) min((int64_t) len, offset - blob.pos)));  //  skip to offset
+            if (!errnum && blob.pos == offset) got = Get(len);
+            break;}
+#endif
+
+        default:
+            break;
+        }
+        if (errnum) return -1;
+        stats.Count(tStats::Query, tStats::BytesIn, got);
+        (**data)->cnt = got; return got;
+    }
+
+    int BlobClose(bool abort = false) {  //  end BLOB write or read, "abort" discards parameters sent but not executed
+        if (!blob.mode) return 0;
+        blob.mode = 0;
+        switch (type)
+        {
+#ifdef MYAPI
+        case MySQL:
+            if (abort) mysql_stmt_reset(blob.stmt);
+            StmtClose(blob.stmt);
+            break;
+#endif
+
+#ifdef ODBCAPI
+        case ODBC:
+        case SqlServer:
+            if (abort) SQLCancel(blob.hStmt);
+            StmtClose(blob.hStmt);
+            break;
+#endif
+
+        default:
+            break;
+        }
+        return 0;
+    }
+
+    uint canary_end = MAGIC;  //  check for buffer overrun/corruption
+};
+
+static thread_local string *ObjectErrStr; //  where we store user-checked/non-API error messages, per calling thread
+static thread_local bool   ObjectErr;    //  set to "true" for user-checked/non-API error messages
+
+static void SetObjectErr(string err)   //  record user-checked/non-API error for this thread
+{
+    delete ObjectErrStr; ObjectErrStr = new string(err); ObjectErr = true;
+}
+
+typedef uintptr_t LvDbRef;  //  handle given to LabVIEW in place of an object pointer, see HandleTable
+
+template <class T> class HandleTable    //  registry of open objects, avoid SEGFAULT on wrong, closed or corrupted references
+{   //  handle bits: [63 or 31..20] generation, [19..16] table tag, [15..0] slot; O(1) to validate and a closed handle never validates
+    //  again: a slot whose generation would wrap (12 bits on 32-bit, 44 on 64-bit) is retired instead of reused
+    static constexpr LvDbRef GenMax = ((LvDbRef) 1 << (sizeof(LvDbRef) * 8 - 20)) - 1;
+    struct Slot {
+        shared_ptr<T> obj;  //  callers hold a copy while they use the object, so closing never frees it under them
+        LvDbRef gen = 1;    //  0 retired
+    };
+    vector<Slot> slots;
+    list<uint32_t> FreeSlots;
+    shared_mutex lock;      //  lookups share the table, open/close are exclusive
+    uint32_t tag;
+    string name;
+
+public:
+    HandleTable(uint32_t t, string n) : tag(t), name(n) {}
+
+    LvDbRef Add(T* obj) {  //  register object and return its handle, 0 (object deleted) if table is full
+        shared_ptr<T> o(obj); uint32_t i;
+        unique_lock<shared_mutex> lk(lock);
+        if (!FreeSlots.empty()) { i = FreeSlots.front(); FreeSlots.pop_front(); }
+        else if (slots.size() > 0xFFFF) { SetObjectErr("Too many open " + name + " objects"); return 0; }
+        else { i = slots.size(); slots.push_back(Slot()); }
+        slots[i].obj = o;
+        return slots[i].gen << 20 | tag << 16 | i;
+    }
+
+    shared_ptr<T> Get(LvDbRef h, bool remove = false) {  //  object for handle, NULL and ObjectErr set if not valid
+        if (h == 0) { SetObjectErr("NULL " + name + " object"); return NULL; }
+        uint32_t i = h & 0xFFFF; LvDbRef gen = h >> 20;
+        shared_ptr<T> obj;
+        if (((h >> 16) & 0xF) == tag)
+        {
+            if (remove)
+            {
+                unique_lock<shared_mutex> lk(lock);
+                if (i < slots.size() && slots[i].gen == gen && slots[i].obj)
+                {
+                    obj = move(slots[i].obj);
+                    if (gen < GenMax) { slots[i].gen = gen + 1; FreeSlots.push_back(i); }
+                    else slots[i].gen = 0;
+                }
+            }
+            else
+            {
+                shared_lock<shared_mutex> lk(lock);
+                if (i < slots.size() && slots[i].gen == gen) obj = slots[i].obj;
+            }
+        }
+        if (!obj) { SetObjectErr("Invalid " + name + " object (closed or non-" + name + " reference)"); return NULL; }
+
+        if (obj->canary_begin == MAGIC && obj->canary_end == MAGIC) { ObjectErr = false; return obj; }
+        else { SetObjectErr("Object memory corrupted"); return NULL; }
+    }
+
+    shared_ptr<T> Remove(LvDbRef h) { return Get(h, true); }  //  unregister, object is deleted once the last caller is done with it
+
+    template <class F> void ForEach(F f) {
+        shared_lock<shared_mutex> lk(lock);
+        for (auto& s : slots) if (s.obj) f(s.obj);
+    }
+};
+static HandleTable<LvDbLib> myObjs(1, "DB");
+
+//  look up handle and hold the connection for the rest of the call, other connections run concurrently
+#define GET_OBJ(ref, fail) shared_ptr<LvDbLib> LvDbObj = myObjs.Get(ref); if (!LvDbObj) return fail;\
+    lock_guard<mutex> ObjLock(LvDbObj->lock);\
+    if (LvDbObj->async) { SetObjectErr("Connection busy with asynchronous query, use Wait"); return fail; }
+
+static int PostDataSet(LvDbRef ref, LStrHandle query, DataSetHdl data, uint16_t ColsTD[], vector<uint16_t>* status)
+{   //  unpack LV DataSet and run prepared statement, return num rows affected
+    GET_OBJ(ref, -1)
+    LvDbLib::tStatCall call(LvDbObj->stats, LvDbLib::tStats::Update);
+    int rows = (**data).dimSizes[0]; int cols = (**data).dimSizes[1];
+    return call(LvDbObj->UpdatePrepared(LStrString(query), (**data).elt, rows, cols, ColsTD, status));
+}
+
+static int QueryParams(LvDbRef ref, LStrHandle query, DataSetHdl params, uint16_t ParamTD[], TypesHdl types, ResultSetHdl results, bool all)
+{   //  run query with the first, or every, DataSet row of parameters and return result rows; keyed by parameters in the result cache
+    int cols = (**types).dimSize; if (cols == 0) return 0;
+    GET_OBJ(ref, -1)
+    LvDbLib::tStatCall call(LvDbObj->stats, LvDbLib::tStats::Query);
+    int rows = (**params).dimSizes[0], n = (**params).dimSizes[1], got; if (!all && rows > 1) rows = 1;
+    LStrHandle* v = (**params).elt;
+    string sql = LStrString(query), key;
+    if (LvDbObj->ResultTtlMs > 0)   //  SQL, result TDs, parameter TDs, then length and bytes of each parameter
+    {
+        key = sql + '\0' + string((char*) (**types).TypeDescriptor, cols) + '\0' + string((char*) ParamTD, n * sizeof(uint16_t));
+        for (int k = 0; k < rows * n; k++) { int32 len = LStrLen(v[k]); key.append((char*) &len, sizeof(len)).append(LStrBuf(v[k]), len); }
+        if ((got = LvDbObj->ResultCacheGet(key, results)) >= 0) return call(got);
+    }
+    if ((got = LvDbObj->QueryPrepared(sql, v, rows, n, ParamTD, types, results)) < 0) return -1;
+    if (key.length()) LvDbObj->ResultCachePut(key, sql, results, got);
+    return call(got);
+}
+
+class LvDbPool {       // pool of warmed connections, checked out with Acquire(), in with Release()
+public:
+    uint canary_begin = MAGIC; //  check for buffer overrun/corruption
+    string ConnectionString, user, pw, db;
+    u_int16_t type;
+    int min, max;           //  connections opened up front, most connections open at once
+    int PingIdle = 1000;    //  ms a connection may sit idle before it is pinged on checkout
+    int busy = 0;           //  connections checked out
+    list<pair<LvDbRef, chrono::steady_clock::time_point>> idle;  //  connections ready for checkout, when released
+    bool closed = false;    //  set by ClosePool(), connections coming back after it are closed instead
+    mutex lock;
+    condition_variable released;
+    uint canary_end = MAGIC;  //  check for buffer overrun/corruption
+
+    LvDbPool(string cs, string u, string p, string d, u_int16_t t, int n, int m) :
+        ConnectionString(cs), user(u), pw(p), db(d), type(t), min(n), max(m < n ? n : m) {}
+};
+static HandleTable<LvDbPool> myPools(2, "pool");
+
+#define GET_POOL(ref, fail) shared_ptr<LvDbPool> pool = myPools.Get(ref); if (!pool) return fail;
+
+static LvDbRef PoolConnect(LvDbPool* pool, LvDbRef PoolRef)  //  open and register a pooled connection, 0 on error
+{
+    LvDbLib* LvDbObj = new LvDbLib(pool->ConnectionString, pool->user, pool->pw, pool->db, pool->type);
+    if (LvDbObj->errnum)
+    {
+        SetObjectErr(LvDbObj->errstr ? *(LvDbObj->errstr) : "Connection failed");
+        delete LvDbObj; return 0;
+    }
+    LvDbObj->pool = PoolRef;
+    return myObjs.Add(LvDbObj);
+}
+
+//  partitioned queries: the same query over N partitions, run by one worker thread per pooled connection at once
+extern "C" LvDbRef Acquire(LvDbRef PoolRef, int timeout);
+extern "C" int Release(LvDbRef PoolRef, LvDbRef ref);
+
+static string Substitute(string s, const string& mark, const string& value)  //  every "mark" in s replaced by value
+{
+    for (size_t at = 0; (at = s.find(mark, at)) != string::npos; at += value.length()) s.replace(at, mark.length(), value);
+    return s;
+}
+
+static int QueryPartitions(LvDbRef PoolRef, const vector<string>& queries, int dop, TypesHdl types, ResultSetHdl results)
+{   //  run queries on up to "dop" pool connections at once (<= 0 all the pool gives), return their rows merged in query order
+    int cols = (**types).dimSize, n = queries.size(); if (cols == 0) return 0;
+    vector<LvDbRef> refs;   //  checked out here, so the error of a failed checkout is the caller's
+    for (int k = 0; k < (dop > 0 && dop < n ? dop : n); k++)
+    {
+        LvDbRef ref = Acquire(PoolRef, 0);
+        if (!ref)
+        {
+            if (refs.empty() && n) return -1;
+            ObjectErr = false; delete ObjectErrStr; ObjectErrStr = NULL; break;  //  run on the connections we got
+        }
+        refs.push_back(ref);
+    }
+    vector<ResultSetHdl> parts(n, (ResultSetHdl) NULL);
+    vector<string> errs(n);     //  per partition, reported on the calling thread as ObjectErr is per thread
+    atomic<int> next{0};        //  next partition to run, workers take them in turn
+    auto Worker = [&](LvDbRef ref) {
+        shared_ptr<LvDbLib> LvDbObj = myObjs.Get(ref); if (!LvDbObj) return;
+        lock_guard<mutex> ObjLock(LvDbObj->lock);
+        for (int k; (k = next++) < n; )
+        {
+            LvDbLib::tStatCall call(LvDbObj->stats, LvDbLib::tStats::Query);
+            int rows;
+            if (!(parts[k] = (ResultSetHdl) DSNewHClr(offsetof(ResultSet, elt)))) errs[k] = "Out of memory";
+            else if ((rows = LvDbObj->Query(queries[k], cols)) < 0 || LvDbObj->GetResults(&rows, cols, types, parts[k]) < 0)
+                errs[k] = LvDbObj->errstr ? *(LvDbObj->errstr) : "Query failed";
+            else { call(rows); continue; }
+            next = n; return;   //  skip the partitions not yet started
+        }
+    };
+    vector<thread> workers;
+    for (LvDbRef ref : refs) workers.emplace_back(Worker, ref);
+    for (thread& t : workers) t.join();
+    for (LvDbRef ref : refs) Release(PoolRef, ref);
+
+    string err; size_t total = 0;
+    for (int k = 0; k < n && err.empty(); k++)
+        if (errs[k].length()) err = "Partition " + to_string(k) + ": " + errs[k];
+        else if (!parts[k]) err = "Partition " + to_string(k) + ": not run";
+        else total += (**parts[k]).dimSizes[0];
+    if (err.empty() && DSSetHandleSize(results, offsetof(ResultSet, elt) + total * cols * sizeof(LStrHandle)) != mgNoErr)
+        err = "Out of memory";
+    size_t row = 0;
+    for (int k = 0; k < n; k++)   //  cells move into results as they are, no copy of the strings
+    {
+        if (!parts[k]) continue;
+        size_t cells = (**parts[k]).dimSizes[0] * cols;
+        if (err.empty()) { memcpy(&(**results).elt[row * cols], (**parts[k]).elt, cells * sizeof(LStrHandle)); row += (**parts[k]).dimSizes[0]; }
+        else for (size_t i = 0; i < cells; i++) if ((**parts[k]).elt[i]) DSDisposeHandle((**parts[k]).elt[i]);
+        DSDisposeHandle(parts[k]);
+    }
+    if (err.length()) { SetObjectErr(err); return -1; }
+    (**results).dimSizes[0] = total; (**results).dimSizes[1] = cols;
+    return total;
+}
+
+//  asynchronous queries: one event loop thread multiplexes every query in flight, instead of one thread per connection
+//  MySQL uses the MariaDB non-blocking API (mysql_*_start/_cont), ODBC polls statements with SQL_ATTR_ASYNC_ENABLE on
+enum { AsyncRead = 1, AsyncWrite = 2, AsyncExcept = 4, AsyncTimer = 8 };   //  same values as MariaDB MYSQL_WAIT_*
+#define ASYNC_TICK 5    //  ms between polls of statements without a socket (ODBC), and of newly queued queries
+
+class LvDbAsync {      //  query in flight, its handle is the ticket returned to LabVIEW and collected by Wait()
+public:
+    uint canary_begin = MAGIC; //  check for buffer overrun/corruption
+    shared_ptr<LvDbLib> obj;    //  connection, reserved (LvDbLib::async) until Wait()
+    string query;
+    bool select;                //  QueryAsync(), rows are read by Wait(); else ExecuteAsync(), rows affected
+    int step = 0;               //  position in AsyncStep() state machine
+    int status = 0;             //  events the pending call waits for, Async* flags
+    int fd = -1;                //  socket to poll, -1 if none
+    chrono::steady_clock::time_point deadline;  //  when a pending AsyncTimer expires
+    atomic<int> done{0};        //  0 running, 1 done, -1 error
+    int errnum = 0; string errstr;
+    long rows = 0;
+#ifdef MYAPI
+    MYSQL_STMT* stmt = NULL;
+    MYSQL_RES* res = NULL;
+#endif
+#ifdef ODBCAPI
+    SQLHSTMT hStmt = NULL;
+#endif
+    uint canary_end = MAGIC;  //  check for buffer overrun/corruption
+
+    LvDbAsync(shared_ptr<LvDbLib> o, string q, bool s) : obj(o), query(q), select(s) {}
+    ~LvDbAsync() {  //  statements not handed over to Wait()
+#ifdef MYAPI
+        if (res) mysql_free_result(res);
+        if (stmt) mysql_stmt_close(stmt);
+#endif
+#ifdef ODBCAPI
+        if (hStmt) SQLFreeHandle(SQL_HANDLE_STMT, hStmt);
 #endif
+    }
+    void Fail(int n, string e) { errnum = n; errstr = e; done = -1; }
+};
+static HandleTable<LvDbAsync> myTickets(3, "ticket");
 
-#ifdef MYCPPAPI
-#define CASE(xTD, cType, method) \
-     case  xTD:\
-            union { cType d; char str[sizeof(cType)]; } xTD ## _;\
-            xTD ## _.d = res->method(i + 1);\
-            (**results).elt[row * cols + i] = (LStrHandle) DSNewHandle(sizeof(int32) + sizeof(cType));\
-            LV_strncpy((**results).elt[row * cols + i], xTD ## _.str, sizeof(cType));
-                            
-        case MySQLpp:
-            try {
-                sql::ResultSet* res = api.mycpp.res; //  sql::ResultSet
-                while (res->next())
-                {
-                    for (int i = 0; i < cols; i++) {
-                        if (!res->isNull(i + 1))
-                            switch ((**types).TypeDescriptor[i])
-                            {
-                            case  Boolean:  //  any of these numeric type might overflow, that's what we'd like to catch
-                            CASE(U8, u_char, getInt)
-                                break;
-                            CASE(I8, char, getInt)
-                                break;
-                            CASE(U16, u_int16_t, getInt)
-                                break;
-                            CASE(I16, int16_t, getInt)
-                                break;
-                            CASE(U32, u_int32_t, getInt)
-                                break;
-                            CASE(I32, int32, getInt)
-                                break;
-                            CASE(SGL, float, getDouble)
-                                break;
-                            CASE(DBL, double, getDouble)
-                                break;
-                            case  String:
-                            default:
-                                (**results).elt[row * cols + i] = (LStrHandle)DSNewHandle(0);
-                                LV_str_cp((**results).elt[row * cols + i], res->getString(i + 1));  //  <- std::string, handles binaries
-                                break;
-                            }
-                    }
-                    row++;
-                }
-                errnum = 0; delete errdata;
+#define GET_TICKET(ref, fail) shared_ptr<LvDbAsync> op = myTickets.Get(ref); if (!op) return fail;
+
+static void AsyncStep(LvDbAsync* op, int ready)  //  advance query without blocking, "ready" events since last step
+{
+    LvDbLib* o = op->obj.get(); int rc = 0;
+    switch (o->type)
+    {
+#ifdef MYAPI
+    case LvDbLib::MySQL:
+#ifdef MARIADB_PACKAGE_VERSION
+       {//  even steps start a call, odd steps continue it; 0-6 prepared query, 10-14 plain statement
+        MYSQL* con = o->api.my.con;
+        while (true)
+        {
+            switch (op->step)
+            {
+            case 0:
+                if (!(op->stmt = mysql_stmt_init(con))) { op->Fail(-1, "Out of memory"); return; }
+                op->status = mysql_stmt_prepare_start(&rc, op->stmt, op->query.c_str(), op->query.length()); break;
+            case 1:
+                op->status = mysql_stmt_prepare_cont(&rc, op->stmt, ready); break;
+            case 2:
+               {int k = 1; mysql_stmt_attr_set(op->stmt, STMT_ATTR_UPDATE_MAX_LENGTH, &k);}
+                op->status = mysql_stmt_execute_start(&rc, op->stmt); break;
+            case 3:
+                op->status = mysql_stmt_execute_cont(&rc, op->stmt, ready); break;
+            case 4:
+                op->status = mysql_stmt_store_result_start(&rc, op->stmt); break;
+            case 5:
+                op->status = mysql_stmt_store_result_cont(&rc, op->stmt, ready); break;
+            case 6:
+                op->done = 1; return;
+            case 10:
+                op->status = mysql_real_query_start(&rc, con, op->query.c_str(), op->query.length()); break;
+            case 11:
+                op->status = mysql_real_query_cont(&rc, con, ready); break;
+            case 12:
+                op->rows = mysql_affected_rows(con);
+                if (!mysql_field_count(con)) { op->done = 1; return; }
+                op->status = mysql_store_result_start(&op->res, con); break;
+            case 13:
+                op->status = mysql_store_result_cont(&op->res, con, ready); break;
+            case 14:    //  statement returned rows, discard them so the connection is usable again
+                if (!op->res) { op->Fail(mysql_errno(con), mysql_error(con)); return; }
+                op->rows = mysql_num_rows(op->res); mysql_free_result(op->res); op->res = NULL;
+                op->done = 1; return;
             }
-            catch (sql::SQLException& e) {
-                errstr = new string(e.what());
-                errnum = e.getErrorCode();
+            if (op->status)     //  waiting on the server, continue on the event loop
+            {
+                op->step |= 1;
+                if (op->status & AsyncTimer)
+                    op->deadline = chrono::steady_clock::now() + chrono::milliseconds(mysql_get_timeout_value_ms(con));
+                return;
             }
-
-            delete api.mycpp.res; delete api.mycpp.stmt;
-            break;
-#undef CASE
+            if (rc)
+            {
+                if (op->step < 10) op->Fail(mysql_stmt_errno(op->stmt), mysql_stmt_error(op->stmt));
+                else op->Fail(mysql_errno(con), mysql_error(con));
+                return;
+            }
+            op->step = (op->step | 1) + 1; ready = 0;
+        }}
+#else
+        op->Fail(-1, "Asynchronous queries need MariaDB Connector/C");
+#endif
+        break;
 #endif
 
-        default:
-            errnum = -1; errstr = new string("Unsupported RDBMS"); return -1;
-            break;
+#ifdef ODBCAPI
+    case LvDbLib::ODBC:
+    case LvDbLib::SqlServer:
+        rc = SQLExecDirect(op->hStmt, (SQLCHAR*) op->query.c_str(), SQL_NTS);  //  re-issued until no longer executing
+        if (rc == SQL_STILL_EXECUTING) { op->status = AsyncTimer; op->deadline = chrono::steady_clock::now(); return; }
+        if (rc == SQL_ERROR)
+        {
+            SQLCHAR buf[1024]; SQLSMALLINT TextLength = 0;
+            SQLGetDiagRec(SQL_HANDLE_STMT, op->hStmt, 1, 0, 0, buf, 1024, &TextLength);
+            op->Fail(-1, string((char*) buf, TextLength)); return;
         }
-        return (*rows = row);
+        if (op->select) SQLSetStmtAttr(op->hStmt, SQL_ATTR_ASYNC_ENABLE, (SQLPOINTER) SQL_ASYNC_ENABLE_OFF, 0);
+        else
+           {SQLLEN n = 0; SQLRowCount(op->hStmt, &n); op->rows = n;
+            SQLFreeHandle(SQL_HANDLE_STMT, op->hStmt); op->hStmt = NULL;}
+        op->done = 1;
+        break;
+#endif
+
+    default:
+        op->Fail(-1, "Unsupported RDBMS");
+        break;
     }
+}
 
-    uint canary_end = MAGIC;  //  check for buffer overrun/corruption
-};
+static mutex AsyncLock;                         //  guards AsyncOps
+static condition_variable AsyncQueued, AsyncDone;
+static list<shared_ptr<LvDbAsync>> AsyncOps;    //  queries in flight on the event loop
+static bool AsyncRunning = false;
 
-class ObjList
+static void AsyncLoop()  //  event loop thread, poll all sockets at once and continue whichever query is ready
 {
-public:
-    LvDbLib* addr;
-    bool deleted;
-    ObjList(LvDbLib* a) { addr = a; deleted = false; }
+    unique_lock<mutex> lk(AsyncLock);
+    while (true)
+    {
+        AsyncQueued.wait(lk, [] { return !AsyncOps.empty(); });
+        vector<shared_ptr<LvDbAsync>> ops(AsyncOps.begin(), AsyncOps.end());
+        lk.unlock();
 
-    bool operator< (const ObjList rhs) const { return addr < rhs.addr; }
-    bool operator<= (const ObjList rhs) const { return addr <= rhs.addr; }
-    bool operator== (const ObjList rhs) const { return addr == rhs.addr; }
-};
-static std::list<ObjList> myObjs;
+        vector<pollfd> fds(ops.size());
+        for (size_t i = 0; i < ops.size(); i++)
+        {
+            fds[i].fd = ops[i]->fd; fds[i].revents = 0;  //  negative fd is skipped by poll(), timer only
+            fds[i].events = (ops[i]->status & AsyncRead ? POLLIN : 0) | (ops[i]->status & AsyncWrite ? POLLOUT : 0) |
+                (ops[i]->status & AsyncExcept ? POLLPRI : 0);
+        }
+        poll(&fds[0], fds.size(), ASYNC_TICK);
+
+        auto now = chrono::steady_clock::now();
+        for (size_t i = 0; i < ops.size(); i++)
+        {
+            int ready = (fds[i].revents & (POLLIN | POLLHUP | POLLERR) ? AsyncRead : 0) |
+                (fds[i].revents & POLLOUT ? AsyncWrite : 0) | (fds[i].revents & POLLPRI ? AsyncExcept : 0);
+            if (ops[i]->status & AsyncTimer && now >= ops[i]->deadline) ready |= AsyncTimer;
+            if (ready) AsyncStep(ops[i].get(), ready);
+        }
 
-static string *ObjectErrStr; //  where we store user-checked/non-API error messages
-static bool   ObjectErr;    //  set to "true" for user-checked/non-API error messages
+        lk.lock();
+        size_t n = AsyncOps.size();
+        AsyncOps.remove_if([](shared_ptr<LvDbAsync>& op) { return op->done != 0; });
+        if (AsyncOps.size() != n) AsyncDone.notify_all();
+    }
+}
 
-bool IsObj(LvDbLib* addr) //  check for corruption/validity, use <list> to track all open connections, avoid SEGFAULT
+static LvDbRef AsyncSubmit(LvDbRef ref, string query, bool select)  //  reserve connection and start query, return ticket
 {
-    if (addr == NULL) { ObjectErrStr = new string("NULL DB object"); ObjectErr = true; return false; }
-    bool b = false;
-    for (auto i : myObjs) { if (i == ObjList(addr)) b = true; }
-    if (!b) { ObjectErrStr = new string("Invalid DB object (unallocated memory or non-DB reference)"); ObjectErr = true; return false; }
+    GET_OBJ(ref, 0)
+    if (query.length() < 1) { SetObjectErr("Query string may not be blank"); return 0; }
+    if (LvDbObj->Busy(query)) { SetObjectErr(*(LvDbObj->errstr)); return 0; }
+    if (!select) LvDbObj->ResultInvalidate(query);
+    LvDbAsync* op = new LvDbAsync(LvDbObj, query, select);
+    switch (LvDbObj->type)
+    {
+#ifdef MYAPI
+    case LvDbLib::MySQL:
+        if (LvDbObj->api.my.con == NULL) { SetObjectErr("Connection closed"); delete op; return 0; }
+#ifdef MARIADB_PACKAGE_VERSION
+        op->fd = mysql_get_socket(LvDbObj->api.my.con);
+#endif
+        op->step = select ? 0 : 10;
+        break;
+#endif
+
+#ifdef ODBCAPI
+    case LvDbLib::ODBC:
+    case LvDbLib::SqlServer:
+        if (SQLAllocHandle(SQL_HANDLE_STMT, LvDbObj->api.odbc.hDbc, &op->hStmt) == SQL_ERROR)
+            { SetObjectErr("SQLAllocHandle failed"); op->hStmt = NULL; delete op; return 0; }
+        LvDbObj->StmtTimeout(op->hStmt);
+        //  drivers without asynchronous execution complete the statement on this thread instead
+        SQLSetStmtAttr(op->hStmt, SQL_ATTR_ASYNC_ENABLE, (SQLPOINTER) SQL_ASYNC_ENABLE_ON, 0);
+        break;
+#endif
+
+    default:
+        break;
+    }
+    LvDbRef ticket = myTickets.Add(op); if (!ticket) return 0;
+    shared_ptr<LvDbAsync> sp = myTickets.Get(ticket);
+    LvDbObj->async = true;
+    AsyncStep(op, 0);   //  send query from here, the event loop only waits for the server
+    if (!op->done)
+    {
+        lock_guard<mutex> lk(AsyncLock);
+        if (!AsyncRunning) { thread(AsyncLoop).detach(); AsyncRunning = true; }
+        AsyncOps.push_back(sp);
+        AsyncQueued.notify_one();
+    }
+    return ticket;
+}
 
-    if (addr->canary_begin == MAGIC && addr->canary_end == MAGIC) { ObjectErr = false; return true; }
-    else { ObjectErr = true; ObjectErrStr = new string("Object memory corrupted"); return false; }
+//  background inserts: EnqueueInsert() copies the rows and returns at once, a writer thread per connection posts them
+//  with UpdatePrepared(), consecutive calls for the same statement coalesced into one batch
+enum { QueueBlock = 0, QueueDropOldest = 1, QueueError = 2 };   //  what EnqueueInsert() does when the queue is full
+
+class LvDbQueue {       //  insert queue of one connection, bounded in rows
+public:
+    struct tRows {      //  rows of one EnqueueInsert() call
+        string sql;
+        vector<uint16_t> td;
+        int rows, cols;
+        string cells;   //  rows * cols LStr records, 8 byte aligned values like UpdateRows() makes: pad, int32 cnt, bytes
+        chrono::steady_clock::time_point queued;
+    };
+    shared_ptr<LvDbLib> obj;
+    int capacity = 100000;  //  rows queued at most
+    int BatchRows = 1000;   //  rows written per batch at most, written as soon as this many are queued
+    int FlushMs = 100;      //  ms the oldest queued row waits for a batch to fill
+    int mode = QueueBlock;  //  backpressure when full
+    int timeout = -1;       //  ms EnqueueInsert() blocks at most in QueueBlock mode, < 0 forever
+    list<tRows> q;
+    int depth = 0, writing = 0;     //  rows queued, rows of the batch being written
+    uint64_t written = 0, dropped = 0, failed = 0;
+    string err;             //  last failed batch, reported once by FlushQueue()
+    bool stop = false, flush = false;
+    mutex lock;
+    condition_variable queued, space, drained;
+    thread writer;
+
+    LvDbQueue(shared_ptr<LvDbLib> o) : obj(o) { writer = thread(&LvDbQueue::Run, this); }
+    ~LvDbQueue() { Stop(); }
+
+    void Stop() {   //  write what is still queued, then end the writer; later EnqueueInsert() calls fail
+        { lock_guard<mutex> lk(lock); stop = true; }
+        queued.notify_one(); space.notify_all();
+        if (writer.joinable() && writer.get_id() != this_thread::get_id()) writer.join();
+    }
+
+    static size_t Aligned(size_t n) { return (n + 7) & ~(size_t) 7; }
+
+    int Enqueue(string sql, LStrHandle v[], int rows, int cols, uint16_t ColsTD[]) {  //  copy rows in, return rows queued or -1
+        if (sql.length() < 1) { SetObjectErr("Query string may not be blank"); return -1; }
+        if (rows * cols == 0) { SetObjectErr("No data to post"); return -1; }
+        size_t size = 0, n = (size_t) rows * cols;
+        for (size_t k = 0; k < n; k++) size += Aligned(2 * sizeof(int32) + LStrLen(v[k]));
+        tRows r = {sql, vector<uint16_t>(ColsTD, ColsTD + cols), rows, cols, string(size, (char) 0), {}};
+        for (size_t k = 0, at = 0; k < n; k++)  //  copied before taking the lock, writer and other callers keep going
+        {
+            int32 cnt = LStrLen(v[k]);
+            memcpy(&r.cells[at + sizeof(int32)], &cnt, sizeof(cnt));
+            if (cnt) memcpy(&r.cells[at + 2 * sizeof(int32)], LStrBuf(v[k]), cnt);
+            at += Aligned(2 * sizeof(int32) + cnt);
+        }
+        unique_lock<mutex> lk(lock);
+        if (stop) { SetObjectErr("Insert queue closed"); return -1; }
+        if (rows > capacity) { SetObjectErr("DataSet larger than the insert queue"); return -1; }
+        auto room = [&] { return stop || depth + rows <= capacity; };
+        if (!room()) switch (mode)
+        {
+        case QueueDropOldest:
+            while (!room()) { depth -= q.front().rows; dropped += q.front().rows; q.pop_front(); }
+            break;
+        case QueueError:
+            SetObjectErr("Insert queue full"); return -1;
+        default:
+            if (timeout < 0) space.wait(lk, room);
+            else if (!space.wait_for(lk, chrono::milliseconds(timeout), room)) { SetObjectErr("Insert queue full"); return -1; }
+            if (stop) { SetObjectErr("Insert queue closed"); return -1; }
+            break;
+        }
+        r.queued = chrono::steady_clock::now();
+        q.push_back(move(r)); depth += rows;
+        if (q.size() == 1 || depth >= BatchRows) queued.notify_one();
+        return rows;
+    }
+
+    void Run() {    //  writer thread, wait for a full batch or the oldest row's deadline, then write without holding the queue
+        unique_lock<mutex> lk(lock);
+        while (true)
+        {
+            if (q.empty())
+            {
+                flush = false; drained.notify_all();
+                if (stop) return;
+                queued.wait(lk); continue;
+            }
+            auto due = q.front().queued + chrono::milliseconds(FlushMs);
+            if (!stop && !flush && depth < BatchRows && chrono::steady_clock::now() < due) { queued.wait_until(lk, due); continue; }
+            vector<tRows> batch; int n = 0;
+            do { n += q.front().rows; batch.push_back(move(q.front())); q.pop_front(); }
+            while (!q.empty() && q.front().sql == batch[0].sql && q.front().td == batch[0].td && n + q.front().rows <= BatchRows);
+            depth -= n; writing = n; space.notify_all();
+            lk.unlock();
+            string e = Write(batch, n);
+            lk.lock();
+            writing = 0;
+            if (e.length()) { failed += n; err = e; } else written += n;
+        }
+    }
+
+    string Write(vector<tRows>& batch, int rows) {  //  post batch with UpdatePrepared(), error text or ""
+        int cols = batch[0].cols;
+        vector<LStr*> master;   //  handles point at the records in place, no LV strings made
+        for (tRows& r : batch)
+            for (size_t at = 0; at < r.cells.length(); at += Aligned(2 * sizeof(int32) + master.back()->cnt))
+                master.push_back((LStr*) &r.cells[at + sizeof(int32)]);
+        vector<LStrHandle> v(master.size());
+        for (size_t k = 0; k < v.size(); k++) v[k] = &master[k];
+        lock_guard<mutex> ObjLock(obj->lock);
+        if (obj->async) return "Connection busy with asynchronous query";
+        LvDbLib::tStatCall call(obj->stats, LvDbLib::tStats::Update);
+        if (call(obj->UpdatePrepared(batch[0].sql, &v[0], rows, cols, &batch[0].td[0])) >= 0) return "";
+        return obj->errstr ? *(obj->errstr) : "Insert failed";
+    }
+};
+static mutex QueuesLock;    //  guards Queues
+static unordered_map<LvDbRef, shared_ptr<LvDbQueue>> Queues;  //  insert queue per connection, made on first use
+
+static shared_ptr<LvDbQueue> GetQueue(LvDbRef ref, bool make)
+{   //  insert queue of connection, NULL if none and not "make"; the connection itself is not held, its writer may be using it
+    shared_ptr<LvDbLib> LvDbObj = myObjs.Get(ref); if (!LvDbObj) return NULL;
+    lock_guard<mutex> lk(QueuesLock);
+    auto it = Queues.find(ref);
+    if (it != Queues.end()) return it->second;
+    if (!make) return NULL;
+    return Queues[ref] = make_shared<LvDbQueue>(LvDbObj);
+}
+
+static void QueueStop(LvDbRef ref)  //  write connection's queued rows and drop its queue, the writer has ended on return
+{
+    shared_ptr<LvDbQueue> q;
+    {
+        lock_guard<mutex> lk(QueuesLock);
+        auto it = Queues.find(ref); if (it == Queues.end()) return;
+        q = it->second; Queues.erase(it);
+    }
+    q->Stop();
 }
 
 extern "C" {  //  functions to be called from LabVIEW.  'extern "C"' is necessary to prevent overload name mangling
 
-    LvDbLib* OpenDB(LStrHandle ConnectionString, LStrHandle user,
+    LvDbRef OpenDB(LStrHandle ConnectionString, LStrHandle user,
         LStrHandle pw, LStrHandle db, u_int16_t type) { //  open DB connection
         LvDbLib* LvDbObj = new LvDbLib(LStrString(ConnectionString), LStrString(user),
             LStrString(pw), LStrString(db), type);
-        ObjList* o = new ObjList(LvDbObj); myObjs.push_back(*o);  //  keep record of all objects to check against SEGFAULT
-        return LvDbObj; //  return pointer to LvDbLib object
+        return myObjs.Add(LvDbObj);  //  keep record of all objects to check against SEGFAULT, return handle
+    }
+
+    LvDbRef OpenDBEx(LStrHandle ConnectionString, LStrHandle user,
+        LStrHandle pw, LStrHandle db, u_int16_t type, LStrHandle options) { //  open DB connection with "key=value;..." options
+        //  MySQL: compress, protocol (tcp|socket|pipe|memory), connect_timeout, read_timeout, write_timeout (s),
+        //  net_buffer_length (bytes), port, socket; ODBC: connect_timeout (login),
+        //  read_timeout (query timeout of each statement), net_buffer_length (packet size), others go to the driver
+        LvDbLib* LvDbObj = new LvDbLib(LStrString(ConnectionString), LStrString(user),
+            LStrString(pw), LStrString(db), type, LStrString(options));
+        return myObjs.Add(LvDbObj);
     }
 
-    int SetSchema(LvDbLib* LvDbObj, LStrHandle schema) { //  set DB schema
-        if (!IsObj(LvDbObj)) return -1;
+    int SetSchema(LvDbRef ref, LStrHandle schema) { //  set DB schema
+        GET_OBJ(ref, -1)
         LvDbObj->SetSchema(LStrString(schema));
         return LvDbObj->errnum;
     }
 
-    int Execute(LvDbLib* LvDbObj, LStrHandle query) { //  run query against connection and return num rows affected
-        if (!IsObj(LvDbObj)) return -1;
-        return LvDbObj->Execute(LStrString(query));
+    int Execute(LvDbRef ref, LStrHandle query) { //  run query against connection and return num rows affected
+        GET_OBJ(ref, -1)
+        LvDbLib::tStatCall call(LvDbObj->stats, LvDbLib::tStats::Execute);
+        return call(LvDbObj->Execute(LStrString(query)));
     }
 
-    int UpdatePrepared(LvDbLib* LvDbObj, LStrHandle query, DataSetHdl data, uint16_t ColsTD[]) { //  run prepared statement and return num rows affected
-        if (!IsObj(LvDbObj)) return -1;
-        int rows = (**data).dimSizes[0]; int cols = (**data).dimSizes[1];
-        string* vals = new string[rows * cols];
-        for (int j = 0; j < rows; j++)
-            for (int i = 0; i < cols; i++) {
-                LStrHandle s = (**data).elt[j * cols + i];
-                if (ColsTD[i] == LvDbObj->String)
-                    vals[j * cols + i] = LStrString(s) + '\0';
-                else
-                    vals[j * cols + i] = LStrString(s);
-            }
-        int NumRows = LvDbObj->UpdatePrepared(LStrString(query), vals, rows, cols, ColsTD);
-        delete[] vals; return NumRows;
+    int ExecuteBatch(LvDbRef ref, LStrArrayHdl queries, I32ArrayHdl counts, int32* failed) { //  run array of statements in one round trip, return total rows affected
+        //  "counts" gets rows affected per statement (-1 if not run), "failed" the index of the first failing statement, -1 if none
+        GET_OBJ(ref, -1)
+        LvDbLib::tStatCall call(LvDbObj->stats, LvDbLib::tStats::Execute);
+        vector<string> q; vector<int32> c;
+        for (int k = 0; k < (**queries).dimSize; k++) q.push_back(LStrString((**queries).elt[k]));
+        int rows = LvDbObj->ExecuteBatch(q, c, failed);
+        if (LvArrayResize((UHandle*) &counts, sizeof(int32), c.size())) { SetObjectErr("Out of memory"); return -1; }
+        if (c.size()) memcpy((**counts).elt, &c[0], c.size() * sizeof(int32));
+        return rows < 0 ? -1 : call(rows);
     }
 
-    int Query(LvDbLib* LvDbObj, LStrHandle query, TypesHdl types, ResultSetHdl results) { //  run query against connection and return result set in flattened strings
+    int UpdatePrepared(LvDbRef ref, LStrHandle query, DataSetHdl data, uint16_t ColsTD[]) { //  run prepared statement and return num rows affected
+        return PostDataSet(ref, query, data, ColsTD, NULL);
+    }
+
+    int UpdatePreparedStatus(LvDbRef ref, LStrHandle query, DataSetHdl data, uint16_t ColsTD[], U16ArrayHdl status) { //  as UpdatePrepared, with per-row status (SQL_PARAM_* values)
+        vector<uint16_t> RowStatus;
+        int NumRows = PostDataSet(ref, query, data, ColsTD, &RowStatus);
+        if (LvArrayResize((UHandle*) &status, sizeof(uInt16), RowStatus.size())) return -1;
+        if (RowStatus.size()) memcpy((**status).elt, &RowStatus[0], RowStatus.size() * sizeof(uInt16));
+        return NumRows;
+    }
+
+    int Begin(LvDbRef ref) { //  open transaction, statements are applied by Commit or discarded by Rollback
+        GET_OBJ(ref, -1)
+        return LvDbObj->Begin();
+    }
+
+    int Commit(LvDbRef ref) { //  commit open transaction and return to autocommit
+        GET_OBJ(ref, -1)
+        return LvDbObj->EndTransaction(true);
+    }
+
+    int Rollback(LvDbRef ref) { //  roll back open transaction and return to autocommit
+        GET_OBJ(ref, -1)
+        return LvDbObj->EndTransaction(false);
+    }
+
+    int SetGroupCommit(LvDbRef ref, int rows, int ms) { //  UpdatePrepared commits every "rows" rows and/or "ms" ms in one transaction, 0 and 0 for autocommit
+        GET_OBJ(ref, -1)
+        LvDbObj->CommitRows = rows; LvDbObj->CommitMs = ms;
+        return 0;
+    }
+
+    int BulkLoad(LvDbRef ref, LStrHandle table, LStrHandle columns, DataSetHdl data, uint16_t ColsTD[], int32* warnings) { //  load DataSet with the RDBMS bulk loader, return rows loaded
+        //  "columns" is the comma-separated column list, blank for all columns in table order
+        GET_OBJ(ref, -1)
+        LvDbLib::tStatCall call(LvDbObj->stats, LvDbLib::tStats::Update);
+        int rows = (**data).dimSizes[0], cols = (**data).dimSizes[1];
+        return call(LvDbObj->BulkLoad(LStrString(table), LStrString(columns), (**data).elt, rows, cols, ColsTD, warnings));
+    }
+
+    int Query(LvDbRef ref, LStrHandle query, TypesHdl types, ResultSetHdl results) { //  run query against connection and return result set in flattened strings
         int rows, cols = (**types).dimSize; if (cols == 0) return 0;  //  number of columns, return if no data columns requested  
-        if (!IsObj(LvDbObj)) return -1;
-        if ((rows = LvDbObj->Query(LStrString(query), cols)) < 0) return -1; //  std::string version of SQL query
+        GET_OBJ(ref, -1)
+        LvDbLib::tStatCall call(LvDbObj->stats, LvDbLib::tStats::Query);
+        string sql = LStrString(query), key = sql + '\0' + string((char*) (**types).TypeDescriptor, cols);
+        if ((rows = LvDbObj->ResultCacheGet(key, results)) >= 0) return call(rows);  //  served without the server
+        if ((rows = LvDbObj->Query(sql, cols)) < 0) return -1; //  std::string version of SQL query
         if (LvDbObj->GetResults(&rows, cols, types, results) < 0) return -1;
-        else return rows;
+        LvDbObj->ResultCachePut(key, sql, results, rows);
+        return call(rows);
+    }
+
+    int QueryPrepared(LvDbRef ref, LStrHandle query, DataSetHdl params, uint16_t ParamTD[], TypesHdl types, ResultSetHdl results) { //  run query with the first row of "params" bound to its markers, return result set in flattened strings
+        return QueryParams(ref, query, params, ParamTD, types, results, false);
+    }
+
+    int QueryPreparedArray(LvDbRef ref, LStrHandle query, DataSetHdl params, uint16_t ParamTD[], TypesHdl types, ResultSetHdl results) { //  run query once per row of "params", return the result rows of all runs in one result set
+        return QueryParams(ref, query, params, ParamTD, types, results, true);
+    }
+
+    int QueryColumnar(LvDbRef ref, LStrHandle query, TypesHdl types, UHandle columns[], LStrArrayHdl nulls) { //  run query and return one native LV array per column
+        //  "columns" is a cluster of 1D arrays, one per TD (DBL[], I32[], String[], ...), "nulls" a NULL bitmap string per column
+        int rows, cols = (**types).dimSize; if (cols == 0) return 0;
+        GET_OBJ(ref, -1)
+        LvDbLib::tStatCall call(LvDbObj->stats, LvDbLib::tStats::Query);
+        if (LvDbObj->Query(LStrString(query), cols) < 0) return -1;
+        if ((rows = LvDbObj->GetColumns(cols, types, columns, nulls)) < 0) return -1;
+        else return call(rows);
+    }
+
+    int QueryIntoClusterArray(LvDbRef ref, LStrHandle query, TypesHdl types, UHandle* clusters, LStrArrayHdl nulls) { //  run query and fill LV array of clusters in place
+        //  "types" are the cluster's field TDs in order, "nulls" a NULL bitmap string per field
+        int rows, cols = (**types).dimSize; if (cols == 0) return 0;
+        GET_OBJ(ref, -1)
+        LvDbLib::tStatCall call(LvDbObj->stats, LvDbLib::tStats::Query);
+        if (LvDbObj->Query(LStrString(query), cols) < 0) return -1;
+        if ((rows = LvDbObj->GetColumns(cols, types, NULL, nulls, clusters)) < 0) return -1;
+        else return call(rows);
+    }
+
+    int QueryOpen(LvDbRef ref, LStrHandle query, TypesHdl types) { //  run query, rows are read in chunks by FetchChunk
+        GET_OBJ(ref, -1)
+        if ((**types).dimSize == 0) return 0;
+        return LvDbObj->QueryOpen(LStrString(query), types);
+    }
+
+    int FetchChunk(LvDbRef ref, int n, ResultSetHdl results) { //  return up to n rows of open query in flattened strings, 0 when done
+        GET_OBJ(ref, -1)
+        return LvDbObj->FetchChunk(n, results);
+    }
+
+    int QueryClose(LvDbRef ref) { //  discard rest of open query
+        GET_OBJ(ref, -1)
+        return LvDbObj->QueryClose();
+    }
+
+    int BlobWriteBegin(LvDbRef ref, LStrHandle query, TypesHdl types) { //  prepare statement, one String/BLOB TD per parameter; values are streamed by BlobWriteChunk
+        GET_OBJ(ref, -1)
+        return LvDbObj->BlobWriteBegin(LStrString(query), types);
+    }
+
+    int BlobWriteChunk(LvDbRef ref, int param, LStrHandle chunk) { //  append chunk to parameter (0-based), ODBC takes the parameters in order
+        GET_OBJ(ref, -1)
+        return LvDbObj->BlobWriteChunk(param, chunk);
+    }
+
+    int BlobWriteEnd(LvDbRef ref, char cancel) { //  execute statement with the streamed parameters and return num rows affected, "cancel" discards them
+        GET_OBJ(ref, -1)
+        LvDbLib::tStatCall call(LvDbObj->stats, LvDbLib::tStats::Update);
+        return call(LvDbObj->BlobWriteEnd(cancel));
+    }
+
+    int BlobReadOpen(LvDbRef ref, LStrHandle query) { //  run query and stay on its first row, return columns to read with BlobRead (0 if no row)
+        GET_OBJ(ref, -1)
+        return LvDbObj->BlobReadOpen(LStrString(query));
+    }
+
+    int BlobRead(LvDbRef ref, int col, int64 offset, int len, LStrHandle* data) { //  read up to len bytes of column (0-based) from offset, return bytes read, 0 at end
+        GET_OBJ(ref, -1)    //  ODBC reads columns and offsets forward only
+        return LvDbObj->BlobRead(col, offset, len, data);
+    }
+
+    int BlobReadClose(LvDbRef ref) { //  discard rest of BLOB query
+        GET_OBJ(ref, -1)
+        return LvDbObj->BlobClose();
+    }
+
+    int CloseDB(LvDbRef ref) { //  close DB connection and free memory
+        {
+            GET_OBJ(ref, -1)
+            if (LvDbObj->pool) { SetObjectErr("Pooled connection, use Release"); return -1; }
+        }
+        QueueStop(ref);     //  queued inserts are written first
+        return myObjs.Remove(ref) ? 0 : -1;  //  deleted here, or by the last call still using it
+    }
+
+    LvDbRef OpenPool(LStrHandle ConnectionString, LStrHandle user,
+        LStrHandle pw, LStrHandle db, u_int16_t type, int min, int max) { //  open pool with "min" warmed connections, up to "max"
+        LvDbPool* p = new LvDbPool(LStrString(ConnectionString), LStrString(user),
+            LStrString(pw), LStrString(db), type, min, max);
+        if (p->max < 1) { SetObjectErr("Pool size must be positive"); delete p; return 0; }
+        LvDbRef PoolRef = myPools.Add(p); if (!PoolRef) return 0;
+        for (int i = 0; i < p->min; i++)
+        {
+            LvDbRef ref = PoolConnect(p, PoolRef);
+            if (!ref)
+            {
+                for (auto c : p->idle) myObjs.Remove(c.first);
+                string err = *ObjectErrStr; myPools.Remove(PoolRef); SetObjectErr(err);
+                return 0;
+            }
+            p->idle.push_back({ref, chrono::steady_clock::now()});
+        }
+        return PoolRef;
+    }
+
+    LvDbRef Acquire(LvDbRef PoolRef, int timeout) { //  check out a connection, waiting up to "timeout" ms if all are busy
+        GET_POOL(PoolRef, 0)
+        unique_lock<mutex> lk(pool->lock);
+        auto deadline = chrono::steady_clock::now() + chrono::milliseconds(timeout > 0 ? timeout : 0);
+        while (true)
+        {
+            if (pool->closed) { SetObjectErr("Connection pool closed"); return 0; }
+            while (!pool->idle.empty())
+            {
+                LvDbRef ref = pool->idle.front().first;
+                bool stale = chrono::steady_clock::now() - pool->idle.front().second > chrono::milliseconds(pool->PingIdle);
+                pool->idle.pop_front();
+                shared_ptr<LvDbLib> LvDbObj = myObjs.Get(ref);
+                if (!LvDbObj) continue;
+                pool->busy++;   //  counted while pinged, so the pool stays within max
+                if (stale)
+                {   //  pinged without the pool lock, a dead server must not stall every other Acquire and Release
+                    lk.unlock();
+                    bool dead; { lock_guard<mutex> ObjLock(LvDbObj->lock); dead = LvDbObj->Ping() != 0; }
+                    lk.lock();
+                    if (dead || pool->closed) { pool->busy--; myObjs.Remove(ref); continue; }  //  dead connection, replace it
+                }
+                LvDbObj->CheckedOut = true; return ref;
+            }
+            if (pool->busy < pool->max)
+            {
+                pool->busy++; lk.unlock();
+                LvDbRef ref = PoolConnect(pool.get(), PoolRef);
+                lk.lock();
+                if (!ref) pool->busy--;
+                else if (pool->closed)  //  ClosePool() ran while connecting and did not see it
+                    { myObjs.Remove(ref); SetObjectErr("Connection pool closed"); return 0; }
+                else if (shared_ptr<LvDbLib> LvDbObj = myObjs.Get(ref)) LvDbObj->CheckedOut = true;
+                return ref;
+            }
+            if (pool->released.wait_until(lk, deadline) == cv_status::timeout && pool->idle.empty())
+                { SetObjectErr("Connection pool exhausted"); return 0; }
+        }
+    }
+
+    int Release(LvDbRef PoolRef, LvDbRef ref) { //  check a connection back in to its pool
+        GET_POOL(PoolRef, -1)
+        {   //  claimed before the connection lock is taken, Acquire() takes them the other way round
+            shared_ptr<LvDbLib> LvDbObj = myObjs.Get(ref); if (!LvDbObj) return -1;
+            if (LvDbObj->pool != PoolRef) { SetObjectErr("Connection does not belong to this pool"); return -1; }
+            if (LvDbObj->async) { SetObjectErr("Connection busy with asynchronous query, use Wait"); return -1; }
+            lock_guard<mutex> lk(pool->lock);   //  a second Release would count it twice and hand it out twice
+            if (!LvDbObj->CheckedOut) { SetObjectErr("Connection already released"); return -1; }
+            LvDbObj->CheckedOut = false;
+        }
+        QueueStop(ref);     //  queued inserts are written by this user, not inside the next one's transaction
+        {
+            GET_OBJ(ref, -1)
+            if (LvDbObj->cursor.open) LvDbObj->QueryClose();
+            if (LvDbObj->blob.mode) LvDbObj->BlobClose(true);
+            if (LvDbObj->InTrans) LvDbObj->EndTransaction(false);
+        }
+        {
+            lock_guard<mutex> lk(pool->lock);
+            pool->busy--;
+            if (pool->closed) { myObjs.Remove(ref); return 0; }     //  nobody left to hand it to
+            pool->idle.push_front({ref, chrono::steady_clock::now()});  //  most recently used first
+        }
+        pool->released.notify_one();
+        return 0;
+    }
+
+    int ClosePool(LvDbRef PoolRef) { //  close idle connections and free pool, connections still checked out become ordinary (CloseDB)
+        GET_POOL(PoolRef, -1)
+        vector<LvDbRef> idle;
+        {
+            lock_guard<mutex> lk(pool->lock);
+            pool->closed = true;
+            for (auto c : pool->idle) idle.push_back(c.first);
+            pool->idle.clear();
+            myObjs.ForEach([&](shared_ptr<LvDbLib> o) { if (o->pool == PoolRef) o->pool = 0; });
+        }
+        pool->released.notify_all();    //  waiting Acquire() calls fail
+        for (LvDbRef ref : idle) { QueueStop(ref); myObjs.Remove(ref); }   //  writers joined without the pool lock
+        myPools.Remove(PoolRef); return 0;
+    }
+
+    int QueryParallel(LvDbRef PoolRef, LStrHandle query, LStrArrayHdl partitions, int dop, TypesHdl types, ResultSetHdl results) { //  run query once per partition on up to "dop" pooled connections at once
+        //  "{p}" in query is replaced by each partition string (name, key list, ...); rows are returned in partition order
+        string sql = LStrString(query); vector<string> queries;
+        for (int k = 0; k < (**partitions).dimSize; k++) queries.push_back(Substitute(sql, "{p}", LStrString((**partitions).elt[k])));
+        return QueryPartitions(PoolRef, queries, dop, types, results);
+    }
+
+    int QueryParallelRange(LvDbRef PoolRef, LStrHandle query, int64 first, int64 last, int parts, int dop, TypesHdl types, ResultSetHdl results) { //  as QueryParallel over key ranges
+        //  [first, last) is split into "parts" even ranges, "{lo}" and "{hi}" in query are replaced by the bounds of each, e.g. "k >= {lo} AND k < {hi}"
+        if (parts < 1 || last < first) { SetObjectErr("Empty key range or no partitions"); return -1; }
+        string sql = LStrString(query); vector<string> queries;
+        uint64_t span = (uint64_t) last - (uint64_t) first;
+        auto Bound = [&](int k) { return to_string((int64) ((uint64_t) first + span / parts * k + min<uint64_t>(k, span % parts))); };
+        for (int k = 0; k < parts; k++) queries.push_back(Substitute(Substitute(sql, "{lo}", Bound(k)), "{hi}", Bound(k + 1)));
+        return QueryPartitions(PoolRef, queries, dop, types, results);
+    }
+
+    int SetQueue(LvDbRef ref, int capacity, int BatchRows, int FlushMs, int mode, int timeout) { //  configure, and start, the connection's insert queue
+        //  holds "capacity" rows; a batch of up to BatchRows rows is written when full or when its oldest row is FlushMs old;
+        //  when the queue is full EnqueueInsert() waits up to "timeout" ms (< 0 forever) (mode 0), drops the oldest rows (1) or fails (2)
+        if (capacity < 1 || BatchRows < 1 || FlushMs < 0 || mode < QueueBlock || mode > QueueError)
+            { SetObjectErr("Invalid insert queue settings"); return -1; }
+        shared_ptr<LvDbQueue> q = GetQueue(ref, true); if (!q) return -1;
+        {
+            lock_guard<mutex> lk(q->lock);
+            q->capacity = capacity; q->BatchRows = BatchRows; q->FlushMs = FlushMs; q->mode = mode; q->timeout = timeout;
+        }
+        q->queued.notify_one(); q->space.notify_all();
+        return 0;
+    }
+
+    int EnqueueInsert(LvDbRef ref, LStrHandle query, DataSetHdl data, uint16_t ColsTD[]) { //  queue DataSet for UpdatePrepared() on the writer thread, return rows queued
+        shared_ptr<LvDbQueue> q = GetQueue(ref, true); if (!q) return -1;  //  errors of the insert itself are reported by FlushQueue()
+        return q->Enqueue(LStrString(query), (**data).elt, (**data).dimSizes[0], (**data).dimSizes[1], ColsTD);
+    }
+
+    int FlushQueue(LvDbRef ref, int timeout) { //  write queued rows now and wait up to "timeout" ms (< 0 forever) until they are
+        //  returns rows still queued (0 when done), -1 on timeout or if a batch failed since the last FlushQueue (its rows are lost)
+        shared_ptr<LvDbQueue> q = GetQueue(ref, false); if (!q) return ObjectErr ? -1 : 0;
+        unique_lock<mutex> lk(q->lock);
+        q->flush = true; q->queued.notify_one();
+        auto done = [&] { return q->q.empty() && !q->writing; };
+        if (timeout < 0) q->drained.wait(lk, done);
+        else if (!q->drained.wait_for(lk, chrono::milliseconds(timeout), done))
+            { SetObjectErr("Timeout flushing insert queue"); return -1; }
+        if (q->err.length()) { SetObjectErr("Queued insert failed: " + q->err); q->err.clear(); return -1; }
+        return q->depth;
+    }
+
+    int GetQueueStatus(LvDbRef ref, int32* depth, uInt64* written, uInt64* dropped, uInt64* failed) { //  rows queued (and being written),
+        //  and rows written, dropped by QueueDropOldest and lost in failed batches since the queue started
+        *depth = 0; *written = *dropped = *failed = 0;
+        shared_ptr<LvDbQueue> q = GetQueue(ref, false); if (!q) return ObjectErr ? -1 : 0;
+        lock_guard<mutex> lk(q->lock);
+        *depth = q->depth + q->writing; *written = q->written; *dropped = q->dropped; *failed = q->failed;
+        return 0;
+    }
+
+    LvDbRef QueryAsync(LvDbRef ref, LStrHandle query) { //  start query and return ticket at once, rows are returned by Wait()
+        return AsyncSubmit(ref, LStrString(query), true);
+    }
+
+    LvDbRef ExecuteAsync(LvDbRef ref, LStrHandle query) { //  start statement and return ticket at once, rows affected are returned by Wait()
+        return AsyncSubmit(ref, LStrString(query), false);
+    }
+
+    int Poll(LvDbRef ticket) { //  0 running, 1 done, -1 failed; call Wait() to collect either way
+        GET_TICKET(ticket, -1)
+        return op->done;
     }
 
-    int CloseDB(LvDbLib* LvDbObj) { //  close DB connection and free memory
-        if (!IsObj(LvDbObj)) return -1;
-        myObjs.remove(LvDbObj); delete LvDbObj; return 0;
+    int Wait(LvDbRef ticket, int timeout, TypesHdl types, ResultSetHdl results) { //  wait up to "timeout" ms (< 0 forever) for query, return rows
+        {   //  on timeout the ticket stays valid, every ticket must be collected to release its connection
+            GET_TICKET(ticket, -1)
+            unique_lock<mutex> lk(AsyncLock);
+            auto finished = [&] { return op->done != 0; };
+            if (timeout < 0) AsyncDone.wait(lk, finished);
+            else if (!AsyncDone.wait_for(lk, chrono::milliseconds(timeout), finished))
+                { SetObjectErr("Timeout waiting for asynchronous query"); return -1; }
+        }
+        shared_ptr<LvDbAsync> op = myTickets.Remove(ticket); if (!op) return -1;  //  collected by another thread
+        shared_ptr<LvDbLib> LvDbObj = op->obj;
+        lock_guard<mutex> ObjLock(LvDbObj->lock);
+        LvDbObj->async = false;
+        delete LvDbObj->errdata; LvDbObj->errdata = new string(op->query);
+        if (op->done < 0)
+        {
+            LvDbObj->errnum = op->errnum; delete LvDbObj->errstr; LvDbObj->errstr = new string(op->errstr);
+            return -1;
+        }
+        LvDbObj->errnum = 0;
+        if (!op->select) return op->rows;
+        int rows = 0, cols = (**types).dimSize;
+        switch (LvDbObj->type)
+        {
+#ifdef MYAPI
+        case LvDbLib::MySQL:
+            LvDbObj->api.my.stmt = op->stmt; op->stmt = NULL;   //  GetResults() closes it
+            break;
+#endif
+#ifdef ODBCAPI
+        case LvDbLib::ODBC:
+        case LvDbLib::SqlServer:
+            LvDbObj->api.odbc.hStmt = op->hStmt; op->hStmt = NULL;
+            break;
+#endif
+        default:
+            break;
+        }
+        if (LvDbObj->GetResults(&rows, cols, types, results, true) < 0) return -1;
+        else return rows;
     }
 
 #if 1    //  the following are utility-ish functions
-    void GetError(LvDbLib* LvDbObj, tLvDbErr* error) { //  get error info from LvDbLib object properties
-        if (LvDbObj == NULL || ObjectErr) {
+    void GetError(LvDbRef ref, tLvDbErr* error) { //  get error info from LvDbLib object properties
+        shared_ptr<LvDbLib> LvDbObj;
+        if (ref && !ObjectErr) LvDbObj = myObjs.Get(ref);
+        if (!LvDbObj) {
             if (!ObjectErr) return; //  no error
             error->errnum = -1;
             LV_str_cp(error->errstr, *ObjectErrStr);
-            ObjectErr = false; delete ObjectErrStr; ObjectErrStr = NULL; //  Clear error, but race conditions may exist, if so, da shit has hit da fan. 
+            ObjectErr = false; delete ObjectErrStr; ObjectErrStr = NULL; //  Clear error, it belongs to the calling thread
         }
         else {
+            lock_guard<mutex> ObjLock(LvDbObj->lock);
             error->errnum = LvDbObj->errnum;
             if(LvDbObj->errstr != NULL) LV_str_cp(error->errstr, *(LvDbObj->errstr));
                 delete LvDbObj->errstr; LvDbObj->errstr = NULL;
@@ -1138,13 +3874,14 @@ extern "C" {  //  functions to be called from LabVIEW.  'extern "C"' is necessar
         }
     }
 
-    int Type(LvDbLib* LvDbObj) { //  get DB API type
-        if (!IsObj(LvDbObj)) return -1;
+    int Type(LvDbRef ref) { //  get DB API type
+        GET_OBJ(ref, -1)
         return LvDbObj->type;
     }
 
-    int SetBufLen(LvDbLib* LvDbObj, int len, char tBuf) { //  set string buffer length, set to zero (0) for blobs and other large strings for dynamic allocation
-        if (!IsObj(LvDbObj)) return -1;
+    int SetBufLen(LvDbRef ref, int len, char tBuf) { //  set buffer size "tBuf": 0 most bytes bound per string column (0 reads every string separately),
+        //  1 string/BLOB chunk (ODBC), 2 rows per UpdatePrepared execute (0 whole DataSet), 3 rows per ODBC fetch in Query
+        GET_OBJ(ref, -1)
         switch (tBuf)
         {
         case 0:
@@ -1154,12 +3891,73 @@ extern "C" {  //  functions to be called from LabVIEW.  'extern "C"' is necessar
         case 1:
             LvDbObj->StrBlobLen = len;
             break;
+        case 2:
+            LvDbObj->ParamSetSize = len;
+            break;
+        case 3:
+            LvDbObj->RowArraySize = len;
+            break;
         }
         return 0;
     }
 
-    int GetBufLen(LvDbLib* LvDbObj, char tBuf) { //  get string buffer length (to restore after retrieval of BLOB, etcetera)
-        if (!IsObj(LvDbObj)) return -1;
+    int SetStmtCache(LvDbRef ref, int size) { //  set number of prepared statements cached per connection, 0 to disable
+        GET_OBJ(ref, -1)
+        LvDbObj->SetStmtCache(size);
+        return 0;
+    }
+
+    int GetStmtCacheStats(LvDbRef ref, int32* hits, int32* misses) { //  get prepared statement cache hits/misses, return statements cached
+        GET_OBJ(ref, -1)
+        *hits = LvDbObj->StmtHits; *misses = LvDbObj->StmtMisses;
+        return LvDbObj->StmtCache.size();
+    }
+
+    int SetResultCache(LvDbRef ref, int ttl, int MaxKB) { //  keep Query results for "ttl" ms in up to MaxKB kB (< 0 unchanged), 0 ttl disables and clears
+        //  results are keyed by SQL text and types, and dropped when this connection writes a table they read
+        GET_OBJ(ref, -1)
+        LvDbObj->SetResultCache(ttl, MaxKB);
+        return 0;
+    }
+
+    int GetResultCacheStats(LvDbRef ref, int32* hits, int32* misses) { //  get result cache hits/misses, return results cached
+        GET_OBJ(ref, -1)
+        *hits = LvDbObj->ResultHits; *misses = LvDbObj->ResultMisses;
+        return LvDbObj->ResultCache.size();
+    }
+
+    int GetStats(LvDbRef ref, U64ArrayHdl counters, U64ArrayHdl hist, char reset) { //  performance counters of connection, all connections if ref is 0
+        //  counters, per op (Query, Execute, UpdatePrepared): calls, rows, errors, bytes in, bytes out, LV handles,
+        //  then us spent in prepare, execute, fetch, convert; hist[op][phase][bucket], bucket b counts [2^b, 2^(b+1)) us
+        //  returns connections counted, "reset" zeroes their counters after reading
+        typedef LvDbLib::tStats S;
+        const int NumCounters = S::Ops * (S::Counters + S::Phases), NumHist = S::Ops * S::Phases * S::Buckets;
+        vector<uInt64> c(NumCounters, 0), h(NumHist, 0); int n = 0;
+        auto Add = [&](shared_ptr<LvDbLib> o) {
+            S& s = o->stats; n++;
+            for (int op = 0; op < S::Ops; op++)
+            {
+                uInt64* p = &c[op * (S::Counters + S::Phases)];
+                for (int k = 0; k < S::Counters; k++) p[k] += s.count[op][k].load(memory_order_relaxed);
+                for (int k = 0; k < S::Phases; k++)
+                {
+                    p[S::Counters + k] += s.us[op][k].load(memory_order_relaxed);
+                    for (int b = 0; b < S::Buckets; b++) h[(op * S::Phases + k) * S::Buckets + b] += s.hist[op][k][b].load(memory_order_relaxed);
+                }
+            }
+            if (reset) s.Reset();
+        };
+        if (ref) { shared_ptr<LvDbLib> LvDbObj = myObjs.Get(ref); if (!LvDbObj) return -1; Add(LvDbObj); }
+        else myObjs.ForEach(Add);
+        if (LvArrayResize((UHandle*) &counters, sizeof(uInt64), NumCounters) || LvArrayResize((UHandle*) &hist, sizeof(uInt64), NumHist))
+            { SetObjectErr("Out of memory"); return -1; }
+        memcpy((**counters).elt, &c[0], NumCounters * sizeof(uInt64));
+        memcpy((**hist).elt, &h[0], NumHist * sizeof(uInt64));
+        return n;
+    }
+
+    int GetBufLen(LvDbRef ref, char tBuf) { //  get string buffer length (to restore after retrieval of BLOB, etcetera)
+        GET_OBJ(ref, -1)
         switch (tBuf)
         {
         case 0:
@@ -1167,9 +3965,13 @@ extern "C" {  //  functions to be called from LabVIEW.  'extern "C"' is necessar
             return LvDbObj->StrBufLen;
         case 1:
             return LvDbObj->StrBlobLen;
+        case 2:
+            return LvDbObj->ParamSetSize;
+        case 3:
+            return LvDbObj->RowArraySize;
         }
     }
 
     char *Version() {return (char*) string(SQL_LVPP_VERSION).c_str();};
 #endif
-}
\ No newline at end of file
+}